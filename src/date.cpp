@@ -4,6 +4,7 @@
  */
 
 #include "date.h"
+#include <cstring>
 
 namespace dateCpp{
 
@@ -120,6 +121,8 @@ time_t makeDate(int day,int month,int year,int hour,int minute,int second){
     tm.tm_hour = hour;
     tm.tm_min = minute;
     tm.tm_sec = second;
+    // deixa o mktime decidir se é horário de verão
+    tm.tm_isdst = -1;
 
     // passa para o formato em segundos desde 1900
     time_t data = mktime(&tm);
@@ -127,6 +130,568 @@ time_t makeDate(int day,int month,int year,int hour,int minute,int second){
     return data;
 }
 
+/**
+ * Coloca a data em uma estrutura tm no horário local (reentrante)
+ * \return false se não conseguir
+ * \param seconds Segundos desde 1900
+ * \param result Estrutura a ser preenchida
+ */
+bool getLocalTime(time_t seconds, tm& result){
+#if defined(_WIN32)
+    return localtime_s(&result, &seconds) == 0;
+#else
+    return localtime_r(&seconds, &result) != NULL;
+#endif
+}
+
+/**
+ * Divisão arredondada para baixo (também para valores negativos)
+ * \return Quociente arredondado para baixo
+ * \param value Dividendo
+ * \param divisor Divisor (positivo)
+ */
+long long getFloorDivision(long long value, long long divisor){
+    long long quotient = value / divisor;
+    if(value % divisor < 0) quotient--;
+    return quotient;
+}
+
+/**
+ * Calcula os dias desde 1/1/1970 de uma data do calendário gregoriano
+ * (sem fuso horário)
+ * \return Dias desde 1/1/1970 (negativo antes)
+ * \param year Ano
+ * \param month Mês (1 - 12)
+ * \param day Dia do mês
+ */
+long long getDaysFromCivil(long long year, int month, int day){
+    // o ano começa em março, assim o dia 29/2 fica no fim do ano
+    year -= (month <= 2);
+    long long era = (year >= 0 ? year : year - 399) / 400;
+    long long yearOfEra = year - era * 400;
+    long long dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+
+    return era * 146097 + dayOfEra - 719468;
+}
+
+/**
+ * Calcula a data do calendário gregoriano a partir dos dias desde 1/1/1970
+ * \param days Dias desde 1/1/1970
+ * \param year Ano
+ * \param month Mês (1 - 12)
+ * \param day Dia do mês
+ */
+void getCivilFromDays(long long days, long long& year, int& month, int& day){
+    days += 719468;
+    long long era = (days >= 0 ? days : days - 146096) / 146097;
+    long long dayOfEra = days - era * 146097;
+    long long yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524
+        - dayOfEra / 146096) / 365;
+    long long dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    long long monthIndex = (5 * dayOfYear + 2) / 153;
+
+    day = (int) (dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+    month = (int) (monthIndex < 10 ? monthIndex + 3 : monthIndex - 9);
+    year = yearOfEra + era * 400 + (month <= 2);
+}
+
+/**
+ * Retorna o horário local de um instante como se fosse UTC
+ * (instante + deslocamento UTC local)
+ * \return Segundos locais desde 1/1/1970 (o próprio instante se não conseguir)
+ * \param seconds Segundos desde 1900
+ */
+long long getLocalSeconds(time_t seconds){
+    tm tm;
+    if(!getLocalTime(seconds, tm))
+        return seconds;
+
+    return getDaysFromCivil(tm.tm_year + 1900LL, tm.tm_mon + 1, tm.tm_mday) * 86400
+        + tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec;
+}
+
+/**
+ * Pares de dígitos de 00 a 99, usados na escrita de campos de largura fixa
+ */
+const char digitPairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/**
+ * Escreve um valor de 0 a 99 com dois dígitos
+ * \return Posição seguinte à escrita
+ * \param buffer Destino
+ * \param value Valor (0 - 99)
+ */
+char* writeTwoDigits(char* buffer, int value){
+    buffer[0] = digitPairs[value * 2];
+    buffer[1] = digitPairs[value * 2 + 1];
+    return buffer + 2;
+}
+
+/**
+ * Converte pares de dígitos ASCII em valores de 0 a 99 com aritmética SWAR<BR>
+ * Os caracteres são lidos como um inteiro little-endian de 64 bits; cada par
+ * de dígitos vira um byte na posição do primeiro dígito do par
+ * \return false se algum caractere marcado em digitMask não for um dígito
+ * \param text Caracteres a serem lidos
+ * \param length Quantidade de caracteres (máximo 8)
+ * \param digitMask 0xFF em cada byte que deve ser um dígito
+ * \param pairs Pares convertidos
+ */
+bool parseDigitPairs(const char* text, int length, uint64_t digitMask, uint64_t& pairs){
+    uint64_t chunk = 0;
+    for(int i = 0; i < length; i++)
+        chunk |= (uint64_t) (unsigned char) text[i] << (8 * i);
+
+    // subtrai '0' de cada dígito; bytes fora de '0' - '9' ficam com o bit alto
+    uint64_t digits = (chunk & digitMask) - (0x3030303030303030ULL & digitMask);
+    if((digits | (digits + 0x7676767676767676ULL)) & 0x8080808080808080ULL & digitMask)
+        return false;
+
+    // dezena * 10 + unidade, em todos os bytes de uma vez
+    pairs = digits * 10 + (digits >> 8);
+    return true;
+}
+
+/**
+ * Retorna um par convertido por parseDigitPairs()
+ * \return Valor de 0 a 99
+ * \param pairs Pares convertidos
+ * \param position Posição do primeiro dígito do par
+ */
+int getDigitPair(uint64_t pairs, int position){
+    return (int) ((pairs >> (8 * position)) & 0xFF);
+}
+
+/**
+ * Verifica se o formato é ISO 8601 / RFC 3339
+ * \return true se for
+ * \param dateFormat Formato
+ */
+bool isIsoFormat(DateFormat dateFormat){
+    return dateFormat == DATE_ISO8601_BASIC || dateFormat == DATE_ISO8601
+        || dateFormat == DATE_RFC3339;
+}
+
+/**
+ * Quantidade de dias de um mês
+ * \return Dias do mês
+ * \param month Mês (1 - 12)
+ * \param year Ano
+ */
+int getDaysInMonth(int month, long long year){
+    static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+    if(month == 2 && ((year % 4 == 0 && year % 100 != 0) || year % 400 == 0))
+        return 29;
+    return days[month - 1];
+}
+
+/**
+ * Nomes dos dias da semana (0 - 6, começando pelo Domingo)
+ */
+extern const char* const weekDayNames[] = {
+    "Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"
+};
+
+/**
+ * Escreve um inteiro sem zeros à esquerda (como o operador << faria)
+ * \return Posição seguinte à escrita
+ * \param buffer Destino
+ * \param value Valor
+ */
+char* writeInteger(char* buffer, long long value){
+    unsigned long long magnitude = (value < 0 ? 0ULL - (unsigned long long) value
+        : (unsigned long long) value);
+    char digits[20];
+    char* p = digits + sizeof digits;
+
+    // dois dígitos por vez, do fim para o começo
+    while(magnitude >= 100){
+        int pair = (int) (magnitude % 100);
+        magnitude /= 100;
+        *--p = digitPairs[pair * 2 + 1];
+        *--p = digitPairs[pair * 2];
+    }
+    if(magnitude >= 10){
+        *--p = digitPairs[magnitude * 2 + 1];
+        *--p = digitPairs[magnitude * 2];
+    }
+    else
+        *--p = (char) ('0' + magnitude);
+
+    if(value < 0) *buffer++ = '-';
+    size_t length = (size_t) (digits + sizeof digits - p);
+    memcpy(buffer, p, length);
+    return buffer + length;
+}
+
+/**
+ * Escreve uma string terminada em '\\0' (sem o '\\0')
+ * \return Posição seguinte à escrita
+ * \param buffer Destino
+ * \param text Texto
+ */
+char* writeText(char* buffer, const char* text){
+    while(*text)
+        *buffer++ = *text++;
+    return buffer;
+}
+
+/**
+ * Escreve uma data já decomposta em um dos formatos não ISO
+ * \return Quantidade de caracteres escritos
+ * \param tm Data decomposta no horário local
+ * \param dateFormat Formato (não ISO)
+ * \param showWeek Se o nome do dia da semana é incluído
+ * \param buffer Destino com pelo menos DATE_MAX_LENGTH + 1 bytes
+ */
+size_t writeStringDate(const tm& tm, DateFormat dateFormat, bool showWeek, char* buffer){
+    char* p = buffer;
+    bool dmy = (dateFormat == DATE_DMY || dateFormat == DATE_DMY_HMS
+        || dateFormat == DATE_DMY_HMS_AMPM);
+    bool ymd = (dateFormat == DATE_YMD || dateFormat == DATE_YMD_HMS
+        || dateFormat == DATE_YMD_HMS_AMPM);
+    bool ampm = (dateFormat == DATE_HMS_AMPM || dateFormat == DATE_DMY_HMS_AMPM
+        || dateFormat == DATE_YMD_HMS_AMPM);
+    bool hms = (ampm || dateFormat == DATE_HMS || dateFormat == DATE_DMY_HMS
+        || dateFormat == DATE_YMD_HMS);
+
+    // parte da data
+    if(dmy){
+        p = writeInteger(p, tm.tm_mday);
+        *p++ = '/';
+        p = writeInteger(p, tm.tm_mon + 1);
+        *p++ = '/';
+        p = writeInteger(p, tm.tm_year + 1900LL);
+    }
+    else if(ymd){
+        p = writeInteger(p, tm.tm_year + 1900LL);
+        *p++ = '/';
+        p = writeInteger(p, tm.tm_mon + 1);
+        *p++ = '/';
+        p = writeInteger(p, tm.tm_mday);
+    }
+
+    // parte da hora
+    if(hms){
+        if(dmy || ymd) *p++ = ' ';
+        p = writeInteger(p, ampm ? getHourInAmPm(tm.tm_hour) : tm.tm_hour);
+        *p++ = ':';
+        p = writeInteger(p, tm.tm_min);
+        *p++ = ':';
+        p = writeInteger(p, tm.tm_sec);
+        if(ampm){
+            *p++ = ' ';
+            p = writeText(p, getAmPmSystem(tm.tm_hour) == AM_SYSTEM ? AM : PM);
+        }
+    }
+
+    if(showWeek && tm.tm_wday >= SUNDAY && tm.tm_wday <= SATURDAY){
+        *p++ = ' ';
+        p = writeText(p, weekDayNames[tm.tm_wday]);
+    }
+
+    *p = '\0';
+    return (size_t) (p - buffer);
+}
+
+/**
+ * Escreve uma data em um buffer, com o mesmo texto de Date::getStringDate()<BR>
+ * Não aloca memória
+ * \return Quantidade de caracteres escritos (0 se não conseguir)
+ * \param seconds Segundos desde 1900
+ * \param dateFormat Indica qual o formato da string a ser utilizado
+ * \param buffer Destino com pelo menos DATE_MAX_LENGTH + 1 bytes
+ * (termina com '\\0')
+ * \param showWeek Opção que indica se o nome do dia da semana é incluído
+ *                 (por padrão sim; ignorada nos formatos ISO 8601 / RFC 3339)
+ */
+size_t formatDate(time_t seconds, DateFormat dateFormat, char* buffer, bool showWeek){
+
+    if(isIsoFormat(dateFormat)){
+        size_t length = formatIsoDate(seconds, 0, dateFormat, buffer);
+        buffer[length] = '\0';
+        return length;
+    }
+
+    tm tm;
+    if(!getLocalTime(seconds, tm)){
+        buffer[0] = '\0';
+        return 0;
+    }
+
+    return writeStringDate(tm, dateFormat, showWeek, buffer);
+}
+
+/**
+ * Escreve uma data já decomposta (horário local) em um buffer, com o mesmo
+ * texto de Date::getStringDate()<BR>
+ * Usa apenas os campos exigidos pelo formato (tm_wday só se showWeek)
+ * \return Quantidade de caracteres escritos (0 para formatos ISO 8601 /
+ * RFC 3339, que precisam do instante)
+ * \param tm Data decomposta
+ * \param dateFormat Indica qual o formato da string a ser utilizado
+ * \param buffer Destino com pelo menos DATE_MAX_LENGTH + 1 bytes
+ * (termina com '\\0')
+ * \param showWeek Opção que indica se o nome do dia da semana é incluído
+ *                 (por padrão sim)
+ */
+size_t formatDate(const tm& tm, DateFormat dateFormat, char* buffer, bool showWeek){
+    if(isIsoFormat(dateFormat)){
+        buffer[0] = '\0';
+        return 0;
+    }
+
+    return writeStringDate(tm, dateFormat, showWeek, buffer);
+}
+
+/**
+ * Retorna o tamanho máximo de uma data em um formato
+ * \return Quantidade máxima de caracteres (sem o '\\0')
+ * \param dateFormat Formato
+ * \param showWeek Se o nome do dia da semana é incluído (por padrão sim)
+ */
+size_t getDateFormatMaxLength(DateFormat dateFormat, bool showWeek){
+    // dd/mm/ + ano com até 11 caracteres; hh:mm:ss; " am"; " Wednesday"
+    const size_t date = 6 + 11, time = 8, ampm = 3, week = 10;
+    size_t length;
+
+    switch(dateFormat){
+    case DATE_DMY:
+    case DATE_YMD:
+        length = date;
+        break;
+    case DATE_HMS:
+        length = time;
+        break;
+    case DATE_HMS_AMPM:
+        length = time + ampm;
+        break;
+    case DATE_DMY_HMS:
+    case DATE_YMD_HMS:
+        length = date + 1 + time;
+        break;
+    case DATE_DMY_HMS_AMPM:
+    case DATE_YMD_HMS_AMPM:
+        length = date + 1 + time + ampm;
+        break;
+    case DATE_ISO8601_BASIC:
+        return 20;
+    case DATE_ISO8601:
+        return 25;
+    default:
+        return DATE_ISO_MAX_LENGTH;
+    }
+
+    return length + (showWeek ? week : 0);
+}
+
+/***************************************************************************
+ * Funções ISO 8601 / RFC 3339
+ ***************************************************************************/
+
+/**
+ * Escreve uma data em um dos formatos ISO 8601 / RFC 3339, no horário local
+ * com o deslocamento UTC (ex.: 2015-03-05T07:04:09.123+01:00)<BR>
+ * Caminho rápido de largura fixa, sem alocação. Se o deslocamento local não
+ * for um número inteiro de minutos, a data é escrita em UTC com sufixo Z
+ * \return Quantidade de caracteres escritos (0 se não conseguir: formato não
+ * ISO, milissegundos fora de 0 - 999 ou ano fora de 0 - 9999)
+ * \param seconds Segundos desde 1900
+ * \param milliseconds Milissegundos (0 - 999; só aparecem em DATE_RFC3339)
+ * \param dateFormat DATE_ISO8601_BASIC, DATE_ISO8601 ou DATE_RFC3339
+ * \param buffer Destino com pelo menos DATE_ISO_MAX_LENGTH + 1 bytes
+ * (termina com '\\0')
+ */
+size_t formatIsoDate(time_t seconds, int milliseconds, DateFormat dateFormat, char* buffer){
+
+    if(!isIsoFormat(dateFormat) || milliseconds < 0 || milliseconds > 999)
+        return 0;
+
+    tm tm;
+    if(!getLocalTime(seconds, tm))
+        return 0;
+
+    // deslocamento = horário local lido como UTC - instante
+    long long local = getDaysFromCivil(tm.tm_year + 1900LL, tm.tm_mon + 1, tm.tm_mday) * 86400
+        + tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec;
+    long long offset = local - seconds;
+    long long year = tm.tm_year + 1900LL;
+    int month = tm.tm_mon + 1, day = tm.tm_mday;
+    int hour = tm.tm_hour, minute = tm.tm_min, second = tm.tm_sec;
+    bool zulu = false;
+
+    // fusos com segundos (hora média local) não cabem em +hh:mm: usa UTC
+    if(offset % 60 != 0){
+        long long days = getFloorDivision(seconds, 86400);
+        long long secondsOfDay = seconds - days * 86400;
+        getCivilFromDays(days, year, month, day);
+        hour = (int) (secondsOfDay / 3600);
+        minute = (int) (secondsOfDay / 60 % 60);
+        second = (int) (secondsOfDay % 60);
+        offset = 0;
+        zulu = true;
+    }
+
+    if(year < 0 || year > 9999)
+        return 0;
+
+    bool extended = (dateFormat != DATE_ISO8601_BASIC);
+    char* p = buffer;
+
+    p = writeTwoDigits(p, (int) (year / 100));
+    p = writeTwoDigits(p, (int) (year % 100));
+    if(extended) *p++ = '-';
+    p = writeTwoDigits(p, month);
+    if(extended) *p++ = '-';
+    p = writeTwoDigits(p, day);
+    *p++ = 'T';
+    p = writeTwoDigits(p, hour);
+    if(extended) *p++ = ':';
+    p = writeTwoDigits(p, minute);
+    if(extended) *p++ = ':';
+    p = writeTwoDigits(p, second);
+
+    if(dateFormat == DATE_RFC3339){
+        *p++ = '.';
+        *p++ = (char) ('0' + milliseconds / 100);
+        p = writeTwoDigits(p, milliseconds % 100);
+    }
+
+    // sufixo: Z só no caso de UTC forçado, para não perder o fuso local
+    if(zulu)
+        *p++ = 'Z';
+    else{
+        *p++ = (offset < 0 ? '-' : '+');
+        if(offset < 0) offset = -offset;
+        p = writeTwoDigits(p, (int) (offset / 3600));
+        if(extended) *p++ = ':';
+        p = writeTwoDigits(p, (int) (offset / 60 % 60));
+    }
+
+    *p = '\0';
+    return (size_t) (p - buffer);
+}
+
+/**
+ * Lê uma data em um dos formatos ISO 8601 / RFC 3339<BR>
+ * Aceita sufixo Z ou deslocamento (+hh:mm, ou +hhmm no formato básico) e
+ * fração de segundo opcional de 1 a 9 dígitos (truncada para milissegundos).
+ * Lê o que formatIsoDate() escreve, recuperando exatamente a mesma data
+ * \return false se a string não estiver no formato ou a data não for válida
+ * \param text Texto a ser lido (não precisa terminar com '\\0')
+ * \param length Tamanho do texto
+ * \param dateFormat DATE_ISO8601_BASIC, DATE_ISO8601 ou DATE_RFC3339
+ * \param seconds Segundos desde 1900 lidos
+ * \param milliseconds Milissegundos lidos (0 se não houver fração)
+ */
+bool parseIsoDate(const char* text, size_t length, DateFormat dateFormat,
+    time_t& seconds, int& milliseconds){
+
+    if(!isIsoFormat(dateFormat))
+        return false;
+
+    bool extended = (dateFormat != DATE_ISO8601_BASIC);
+    size_t position = (extended ? 19 : 15);
+    uint64_t pairs;
+    int year, month, day, hour, minute, second;
+
+    // parte fixa mais ao menos um caractere de sufixo
+    if(length < position + 1)
+        return false;
+
+    if(extended){
+        // yyyy-mm-ddThh:mm:ss
+        if(text[4] != '-' || text[7] != '-' || (text[10] != 'T' && text[10] != 't')
+            || text[13] != ':' || text[16] != ':')
+            return false;
+
+        if(!parseDigitPairs(text, 8, 0x00FFFF00FFFFFFFFULL, pairs)) return false;
+        year = getDigitPair(pairs, 0) * 100 + getDigitPair(pairs, 2);
+        month = getDigitPair(pairs, 5);
+
+        if(!parseDigitPairs(text + 8, 2, 0xFFFFULL, pairs)) return false;
+        day = getDigitPair(pairs, 0);
+
+        if(!parseDigitPairs(text + 11, 8, 0xFFFF00FFFF00FFFFULL, pairs)) return false;
+        hour = getDigitPair(pairs, 0);
+        minute = getDigitPair(pairs, 3);
+        second = getDigitPair(pairs, 6);
+    }
+    else{
+        // yyyymmddThhmmss
+        if(text[8] != 'T' && text[8] != 't')
+            return false;
+
+        if(!parseDigitPairs(text, 8, 0xFFFFFFFFFFFFFFFFULL, pairs)) return false;
+        year = getDigitPair(pairs, 0) * 100 + getDigitPair(pairs, 2);
+        month = getDigitPair(pairs, 4);
+        day = getDigitPair(pairs, 6);
+
+        if(!parseDigitPairs(text + 9, 6, 0x0000FFFFFFFFFFFFULL, pairs)) return false;
+        hour = getDigitPair(pairs, 0);
+        minute = getDigitPair(pairs, 2);
+        second = getDigitPair(pairs, 4);
+    }
+
+    if(month < 1 || month > 12 || day < 1 || day > getDaysInMonth(month, year)
+        || hour > 23 || minute > 59 || second > 59)
+        return false;
+
+    // fração de segundo opcional
+    milliseconds = 0;
+    if(text[position] == '.' || text[position] == ','){
+        size_t first = ++position;
+        int scale = 100;
+        while(position < length && position - first < 9
+            && text[position] >= '0' && text[position] <= '9'){
+            milliseconds += (text[position] - '0') * scale;
+            scale /= 10;
+            position++;
+        }
+        if(position == first || position >= length)
+            return false;
+    }
+
+    // deslocamento UTC
+    long long offset = 0;
+    char sign = text[position++];
+    if(sign == 'Z' || sign == 'z'){
+        if(position != length) return false;
+    }
+    else if(sign == '+' || sign == '-'){
+        int offsetHour, offsetMinute;
+        if(extended){
+            if(length - position != 5 || text[position + 2] != ':') return false;
+            if(!parseDigitPairs(text + position, 5, 0xFFFF00FFFFULL, pairs)) return false;
+            offsetHour = getDigitPair(pairs, 0);
+            offsetMinute = getDigitPair(pairs, 3);
+        }
+        else{
+            if(length - position != 4) return false;
+            if(!parseDigitPairs(text + position, 4, 0xFFFFFFFFULL, pairs)) return false;
+            offsetHour = getDigitPair(pairs, 0);
+            offsetMinute = getDigitPair(pairs, 2);
+        }
+        if(offsetHour > 23 || offsetMinute > 59)
+            return false;
+        offset = offsetHour * 3600 + offsetMinute * 60;
+        if(sign == '-') offset = -offset;
+    }
+    else
+        return false;
+
+    seconds = (time_t) (getDaysFromCivil(year, month, day) * 86400
+        + hour * 3600 + minute * 60 + second - offset);
+    return true;
+}
+
 /***************************************************************************
  * Funções da classe Date
  ***************************************************************************/
@@ -226,6 +791,24 @@ bool Date::setDate(time_t seconds){
     }
 }
 
+/**
+ * Configura data a partir de uma string ISO 8601 / RFC 3339
+ * (veja parseIsoDate())
+ * \return false se não conseguir (string ou data não válida)
+ * \param dateString String a ser lida
+ * \param dateFormat DATE_ISO8601_BASIC, DATE_ISO8601 ou DATE_RFC3339
+ */
+bool Date::setDate(const string& dateString, DateFormat dateFormat){
+    time_t seconds;
+    int milliseconds;
+
+    // lê a string; os milissegundos são descartados
+    if(!parseIsoDate(dateString.data(), dateString.size(), dateFormat, seconds, milliseconds))
+        return false;
+
+    return setDate(seconds);
+}
+
 /**
  * Retorna a data em segundos desde 1900
  * \return Segundos desde 1900
@@ -285,89 +868,10 @@ int Date::getDateComponent(DateComponent dateComponent){
  *                 (por padrão sim)
  */
 void Date::getStringDate(DateFormat dateFormat, string& dateString, bool showWeek){
+    char buffer[DATE_MAX_LENGTH + 1];
 
-    tm* tm = localtime(&(data->secondsFull));
-    int day,month,year,hour,min,sec;
-    string ampm;
-
-    if(dateFormat==DATE_DMY || dateFormat==DATE_YMD || dateFormat==DATE_DMY_HMS
-        || dateFormat==DATE_YMD_HMS || dateFormat==DATE_DMY_HMS_AMPM
-        || dateFormat==DATE_YMD_HMS_AMPM){
-        day = tm->tm_mday;
-        month = tm->tm_mon+1;
-        year = tm->tm_year+1900;
-    }
-
-    if(dateFormat==DATE_HMS || dateFormat==DATE_DMY_HMS || dateFormat==DATE_YMD_HMS){
-        hour = tm->tm_hour;
-        min = tm->tm_min;
-        sec = tm->tm_sec;
-    }
-
-    if(dateFormat==DATE_HMS_AMPM || dateFormat==DATE_DMY_HMS_AMPM
-        || dateFormat==DATE_YMD_HMS_AMPM){
-        hour = getHourInAmPm(tm->tm_hour);
-        min = tm->tm_min;
-        sec = tm->tm_sec;
-        ampm = (getAmPmSystem(tm->tm_hour)==AM_SYSTEM ? AM : PM);
-    }
-
-    ostringstream os;
-    switch(dateFormat){
-
-    case DATE_DMY:
-        os << day <<"/"<< month <<"/"<<year;
-        break;
-    case DATE_YMD:
-        os << year <<"/"<< month <<"/"<< day;
-        break;
-    case DATE_HMS:
-        os << hour << ":" << min << ":" << sec;
-        break;
-    case DATE_HMS_AMPM:
-        os << hour << ":" << min << ":" << sec << " " << ampm;
-        break;
-    case DATE_DMY_HMS:
-        os << day <<"/"<< month <<"/"<< year <<" "<< hour <<":"<< min <<":"<<sec;
-        break;
-    case DATE_YMD_HMS:
-        os << year <<"/"<< month <<"/"<< day <<" "<< hour <<":"<< min <<":"<<sec;
-        break;
-    case DATE_DMY_HMS_AMPM:
-        os << day <<"/"<< month <<"/"<< year <<" "<< hour <<":"<< min <<":"<<sec<<" "<<ampm;
-        break;
-    case DATE_YMD_HMS_AMPM:
-        os << year <<"/"<< month <<"/"<< day <<" "<< hour <<":"<< min <<":"<<sec<<" "<<ampm;
-    }
-
-    dateString = os.str();
-
-    if(showWeek){
-
-        switch(tm->tm_wday){
-        case SUNDAY:
-            dateString += " Sunday";
-            break;
-        case MONDAY:
-            dateString += " Monday";
-            break;
-        case TUESDAY:
-            dateString += " Tuesday";
-            break;
-        case WEDNESDAY:
-            dateString += " Wednesday";
-            break;
-        case THURSDAY:
-            dateString += " Thursday";
-            break;
-        case FRIDAY:
-            dateString += " Friday";
-            break;
-        case SATURDAY:
-            dateString += " Saturday";
-        }
-    }
-
+    // escreve no buffer, sem ostringstream
+    dateString.assign(buffer, formatDate(data->secondsFull, dateFormat, buffer, showWeek));
 }
 
 /**
@@ -472,6 +976,14 @@ bool Date::addDateComponent(DateComponent dateComponent, int value, bool add){
  */
 void Date::printDate(DateFormat dateFormat, bool showWeek){
 
+    // formatos ISO 8601 / RFC 3339 não incluem o dia da semana
+    if(isIsoFormat(dateFormat)){
+        char buffer[DATE_ISO_MAX_LENGTH + 1];
+        buffer[formatIsoDate(data->secondsFull, 0, dateFormat, buffer)] = '\0';
+        cout<<buffer<<endl;
+        return;
+    }
+
     // coloca data em uma estrutura struct tm (ver time.h)
     tm* tm = localtime(&(data->secondsFull));
 
@@ -525,6 +1037,10 @@ void Date::printDate(DateFormat dateFormat, bool showWeek){
         else
             cout<<" "<<PM;
         break;
+
+    default:
+        // formatos ISO 8601 / RFC 3339 já tratados acima
+        break;
     }
 
     // imprime o nome do dia da semana, se foi solicitado
@@ -574,7 +1090,8 @@ bool Date::validateDate(int day, int month, int year, int hour, int minute, int
     // agora vamos validar o dia
     switch(month){
     case 2:
-        if(year%4==0){
+        // ano bissexto: divisível por 4, exceto séculos não divisíveis por 400
+        if((year%4==0 && year%100!=0) || year%400==0){
             if(day>29) return false;
         }
         else if(day>28)return false;
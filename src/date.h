@@ -11,6 +11,7 @@
 #include <string>
 #include <sstream>
 #include <new>
+#include <stdint.h>
 
 using std::cout;
 using std::endl;
@@ -45,9 +46,24 @@ enum DateFormat{
     DATE_DMY_HMS, ///< dd/mm/yyyy h:m:s 24 hours
     DATE_YMD_HMS, ///< yyyy/mm/dd h:m:s 24 hours
     DATE_DMY_HMS_AMPM, ///< dd/mm/yyyy h:m:s am/pm format
-    DATE_YMD_HMS_AMPM ///< yyyy/mm/dd h:m:s am/pm format
+    DATE_YMD_HMS_AMPM, ///< yyyy/mm/dd h:m:s am/pm format
+    DATE_ISO8601_BASIC, ///< yyyymmddThhmmss+hhmm (ISO 8601 basic)
+    DATE_ISO8601, ///< yyyy-mm-ddThh:mm:ss+hh:mm (ISO 8601 extended)
+    DATE_RFC3339 ///< yyyy-mm-ddThh:mm:ss.sss+hh:mm (RFC 3339, milliseconds)
 };
 
+/**
+ * Tamanho máximo (sem o '\\0') de uma data nos formatos DATE_ISO8601_BASIC,
+ * DATE_ISO8601 e DATE_RFC3339
+ */
+#define DATE_ISO_MAX_LENGTH 29
+
+/**
+ * Tamanho máximo (sem o '\\0') de uma data em qualquer formato, com o dia
+ * da semana (ex.: dd/mm/yyyy h:m:s am Wednesday, com ano de até 11 caracteres)
+ */
+#define DATE_MAX_LENGTH 40
+
 /**
  * Enumerador das partes da semana
  */
@@ -123,6 +139,15 @@ public:
      */
     bool setDate(time_t seconds);
 
+    /**
+     * Configura data a partir de uma string ISO 8601 / RFC 3339
+     * (veja parseIsoDate())
+     * \return false se não conseguir (string ou data não válida)
+     * \param dateString String a ser lida
+     * \param dateFormat DATE_ISO8601_BASIC, DATE_ISO8601 ou DATE_RFC3339
+     */
+    bool setDate(const string& dateString, DateFormat dateFormat);
+
     /**
      * Retorna a data em segundos desde 1900
      * \return Segundos desde 1900
@@ -151,7 +176,7 @@ public:
      *            (veja o enumerador DateFormat neste header file)
      * \param dateString String a ser preenchida
      * \param showWeek Opção que indica se o nome do dia da semana é incluído
-     *                 (por padrão sim)
+     *                 (por padrão sim; ignorada nos formatos ISO 8601 / RFC 3339)
      */
     void getStringDate(DateFormat dateFormat, string& dateString, bool showWeek=true);
 
@@ -175,7 +200,7 @@ public:
      * \param dateFormat Enumerador que indica o formato da string
      *          a ser utilizado (veja o enumerador neste header file)
      * \param showWeek Se o nome do dia da semana deve ser mostrado
-     *                  (sim por padrão)
+     *                  (sim por padrão; ignorada nos formatos ISO 8601 / RFC 3339)
      */
     void printDate(DateFormat dateFormat, bool showWeek=true);
 
@@ -208,6 +233,72 @@ private:
     DateStruct* data;
 };
 
+/**
+ * Escreve uma data em um buffer, com o mesmo texto de Date::getStringDate()<BR>
+ * Não aloca memória
+ * \return Quantidade de caracteres escritos (0 se não conseguir)
+ * \param seconds Segundos desde 1900
+ * \param dateFormat Indica qual o formato da string a ser utilizado
+ * \param buffer Destino com pelo menos DATE_MAX_LENGTH + 1 bytes
+ * (termina com '\\0')
+ * \param showWeek Opção que indica se o nome do dia da semana é incluído
+ *                 (por padrão sim; ignorada nos formatos ISO 8601 / RFC 3339)
+ */
+size_t formatDate(time_t seconds, DateFormat dateFormat, char* buffer, bool showWeek=true);
+
+/**
+ * Escreve uma data já decomposta (horário local) em um buffer, com o mesmo
+ * texto de Date::getStringDate()<BR>
+ * Usa apenas os campos exigidos pelo formato (tm_wday só se showWeek)
+ * \return Quantidade de caracteres escritos (0 para formatos ISO 8601 /
+ * RFC 3339, que precisam do instante)
+ * \param tm Data decomposta
+ * \param dateFormat Indica qual o formato da string a ser utilizado
+ * \param buffer Destino com pelo menos DATE_MAX_LENGTH + 1 bytes
+ * (termina com '\\0')
+ * \param showWeek Opção que indica se o nome do dia da semana é incluído
+ *                 (por padrão sim)
+ */
+size_t formatDate(const tm& tm, DateFormat dateFormat, char* buffer, bool showWeek=true);
+
+/**
+ * Retorna o tamanho máximo de uma data em um formato
+ * \return Quantidade máxima de caracteres (sem o '\\0')
+ * \param dateFormat Formato
+ * \param showWeek Se o nome do dia da semana é incluído (por padrão sim)
+ */
+size_t getDateFormatMaxLength(DateFormat dateFormat, bool showWeek=true);
+
+/**
+ * Escreve uma data em um dos formatos ISO 8601 / RFC 3339, no horário local
+ * com o deslocamento UTC (ex.: 2015-03-05T07:04:09.123+01:00)<BR>
+ * Caminho rápido de largura fixa, sem alocação. Se o deslocamento local não
+ * for um número inteiro de minutos, a data é escrita em UTC com sufixo Z
+ * \return Quantidade de caracteres escritos (0 se não conseguir: formato não
+ * ISO, milissegundos fora de 0 - 999 ou ano fora de 0 - 9999)
+ * \param seconds Segundos desde 1900
+ * \param milliseconds Milissegundos (0 - 999; só aparecem em DATE_RFC3339)
+ * \param dateFormat DATE_ISO8601_BASIC, DATE_ISO8601 ou DATE_RFC3339
+ * \param buffer Destino com pelo menos DATE_ISO_MAX_LENGTH + 1 bytes
+ * (termina com '\\0')
+ */
+size_t formatIsoDate(time_t seconds, int milliseconds, DateFormat dateFormat, char* buffer);
+
+/**
+ * Lê uma data em um dos formatos ISO 8601 / RFC 3339<BR>
+ * Aceita sufixo Z ou deslocamento (+hh:mm, ou +hhmm no formato básico) e
+ * fração de segundo opcional de 1 a 9 dígitos (truncada para milissegundos).
+ * Lê o que formatIsoDate() escreve, recuperando exatamente a mesma data
+ * \return false se a string não estiver no formato ou a data não for válida
+ * \param text Texto a ser lido (não precisa terminar com '\\0')
+ * \param length Tamanho do texto
+ * \param dateFormat DATE_ISO8601_BASIC, DATE_ISO8601 ou DATE_RFC3339
+ * \param seconds Segundos desde 1900 lidos
+ * \param milliseconds Milissegundos lidos (0 se não houver fração)
+ */
+bool parseIsoDate(const char* text, size_t length, DateFormat dateFormat,
+    time_t& seconds, int& milliseconds);
+
 } /** namespace dateCpp */
 
 #endif /* DATE_HPP_ */
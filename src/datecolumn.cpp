@@ -0,0 +1,213 @@
+/**
+ * \file datecolumn.cpp
+ * Implementação do arquivo datecolumn.h
+ */
+
+#include "datecolumn.h"
+#include <cstring>
+
+#if __cplusplus >= 201103L
+#include <thread>
+#endif
+
+namespace dateCpp{
+
+/***************************************************************************
+ * Estruturas
+ ***************************************************************************/
+
+/**
+ * Parte da coluna formatada por uma thread
+ */
+struct DateColumnChunk{
+    const time_t* seconds;
+    size_t begin;
+    size_t end;
+    DateFormat dateFormat;
+    bool showWeek;
+    // região exclusiva da parte no buffer
+    char* output;
+    // offsets relativos a output
+    int32_t* offsets;
+    // caracteres escritos
+    size_t length;
+};
+
+/***************************************************************************
+ * Funções auxiliares
+ ***************************************************************************/
+
+/**
+ * Menor quantidade de datas por thread
+ */
+#define DATECOLUMN_MIN_CHUNK 4096
+
+/**
+ * Formata as datas de uma parte da coluna
+ * \param chunk Parte a ser formatada
+ */
+void formatDateColumnChunk(DateColumnChunk* chunk){
+    char* p = chunk->output;
+
+    for(size_t i = chunk->begin; i < chunk->end; i++){
+        p += formatDate(chunk->seconds[i], chunk->dateFormat, p, chunk->showWeek);
+        chunk->offsets[i + 1] = (int32_t) (p - chunk->output);
+    }
+
+    chunk->length = (size_t) (p - chunk->output);
+}
+
+/***************************************************************************
+ * Funções da classe DateStringColumn
+ ***************************************************************************/
+
+/**
+ * Construtor padrão<BR>
+ * Cria uma coluna vazia
+ */
+DateStringColumn::DateStringColumn(){
+    offsets.push_back(0);
+    dataLength = 0;
+}
+
+/**
+ * Formata as datas, substituindo o conteúdo da coluna<BR>
+ * Cada string é igual à de Date::getStringDate() para a mesma data
+ * (vazia se a data não puder ser convertida)
+ * \return false se o texto total passar do limite de offsets de 32 bits
+ * (a coluna fica vazia)
+ * \param seconds Datas em segundos desde 1900
+ * \param count Quantidade de datas
+ * \param dateFormat Indica qual o formato da string a ser utilizado
+ * \param showWeek Opção que indica se o nome do dia da semana é incluído
+ *                 (por padrão sim)
+ * \param threads Quantidade de threads (padrão 1; 0 usa todos os núcleos;
+ *                sem suporte a C++11 o trabalho é sempre feito em uma).
+ *                Na glibc, localtime_r serializa as threads em uma trava
+ *                global do fuso, então só a escrita do texto roda em
+ *                paralelo: o ganho é limitado (nenhum nos benchmarks
+ *                de test/main.cpp). Se não for possível criar uma
+ *                thread, as partes restantes são feitas na atual
+ */
+bool DateStringColumn::format(const time_t* seconds, size_t count, DateFormat dateFormat,
+    bool showWeek, unsigned threads){
+
+#if __cplusplus >= 201103L
+    if(threads == 0)
+        threads = std::thread::hardware_concurrency();
+#else
+    threads = 1;
+#endif
+
+    // cada thread formata ao menos DATECOLUMN_MIN_CHUNK datas
+    size_t chunkCount = count / DATECOLUMN_MIN_CHUNK;
+    if(chunkCount > threads) chunkCount = threads;
+    if(chunkCount < 1) chunkCount = 1;
+
+    // reserva o tamanho máximo: cada parte escreve na sua própria região,
+    // com um byte a mais para o '\0' de formatDate()
+    size_t maxLength = getDateFormatMaxLength(dateFormat, showWeek);
+    if(data.size() < count * maxLength + chunkCount)
+        data.resize(count * maxLength + chunkCount);
+    offsets.resize(count + 1);
+    offsets[0] = 0;
+
+    std::vector<DateColumnChunk> chunks(chunkCount);
+    for(size_t k = 0; k < chunkCount; k++){
+        DateColumnChunk& chunk = chunks[k];
+        chunk.seconds = seconds;
+        chunk.begin = count * k / chunkCount;
+        chunk.end = count * (k + 1) / chunkCount;
+        chunk.dateFormat = dateFormat;
+        chunk.showWeek = showWeek;
+        chunk.output = &data[0] + chunk.begin * maxLength + k;
+        chunk.offsets = &offsets[0];
+        chunk.length = 0;
+    }
+
+#if __cplusplus >= 201103L
+    // a thread atual formata a primeira parte; com a reserva feita antes,
+    // push_back não realoca (nem lança) com threads já iniciadas
+    std::vector<std::thread> workers;
+    workers.reserve(chunkCount - 1);
+    size_t started = 1;
+    try{
+        for(; started < chunkCount; started++)
+            workers.push_back(std::thread(formatDateColumnChunk, &chunks[started]));
+    }
+    catch(...){
+        // sem recursos para mais threads: as partes restantes ficam com a
+        // thread atual (as já iniciadas ainda são esperadas abaixo)
+    }
+    formatDateColumnChunk(&chunks[0]);
+    for(size_t k = started; k < chunkCount; k++)
+        formatDateColumnChunk(&chunks[k]);
+    for(size_t k = 0; k < workers.size(); k++)
+        workers[k].join();
+#else
+    formatDateColumnChunk(&chunks[0]);
+#endif
+
+    // junta as regiões no início do buffer e corrige os offsets
+    size_t base = 0;
+    for(size_t k = 0; k < chunkCount; k++){
+        DateColumnChunk& chunk = chunks[k];
+
+        if(base + chunk.length > 0x7FFFFFFF){
+            offsets.assign(1, 0);
+            dataLength = 0;
+            return false;
+        }
+
+        memmove(&data[0] + base, chunk.output, chunk.length);
+        for(size_t i = chunk.begin; i < chunk.end; i++)
+            offsets[i + 1] += (int32_t) base;
+        base += chunk.length;
+    }
+
+    dataLength = base;
+    return true;
+}
+
+/**
+ * Retorna a quantidade de strings
+ * \return Quantidade de strings
+ */
+size_t DateStringColumn::size() const{
+    return offsets.size() - 1;
+}
+
+/**
+ * Retorna o buffer de caracteres (sem '\\0' entre as strings)
+ * \return Ponteiro para o primeiro caractere
+ */
+const char* DateStringColumn::getData() const{
+    return data.empty() ? NULL : &data[0];
+}
+
+/**
+ * Retorna o tamanho do buffer de caracteres
+ * \return Quantidade de caracteres
+ */
+size_t DateStringColumn::getDataLength() const{
+    return dataLength;
+}
+
+/**
+ * Retorna os offsets (size() + 1 valores, o primeiro é 0)
+ * \return Ponteiro para o primeiro offset
+ */
+const int32_t* DateStringColumn::getOffsets() const{
+    return &offsets[0];
+}
+
+/**
+ * Copia uma string da coluna
+ * \param index Posição (0 - size()-1)
+ * \param dateString String a ser preenchida
+ */
+void DateStringColumn::getString(size_t index, string& dateString) const{
+    dateString.assign(&data[0] + offsets[index], offsets[index + 1] - offsets[index]);
+}
+
+} /** namespace dateCpp */
@@ -0,0 +1,107 @@
+/**
+ * \file datecolumn.h
+ * Módulo que converte vários timestamps em strings de uma só vez, no
+ * layout de coluna de strings do Apache Arrow
+ */
+
+#ifndef DATECOLUMN_HPP_
+#define DATECOLUMN_HPP_
+
+#include <ctime>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "date.h"
+
+namespace dateCpp{
+
+/**
+ * Classe que guarda N datas formatadas em um buffer contíguo de caracteres
+ * e N + 1 offsets: a string i ocupa [offsets[i], offsets[i + 1]) do buffer
+ * (layout de StringArray do Apache Arrow)<BR>
+ * Os buffers são reaproveitados entre chamadas de format(); não há alocação
+ * por elemento.
+ */
+class DateStringColumn {
+public:
+
+    /**
+     * Construtor padrão<BR>
+     * Cria uma coluna vazia
+     */
+    DateStringColumn();
+
+    /**
+     * Formata as datas, substituindo o conteúdo da coluna<BR>
+     * Cada string é igual à de Date::getStringDate() para a mesma data
+     * (vazia se a data não puder ser convertida)
+     * \return false se o texto total passar do limite de offsets de 32 bits
+     * (a coluna fica vazia)
+     * \param seconds Datas em segundos desde 1900
+     * \param count Quantidade de datas
+     * \param dateFormat Indica qual o formato da string a ser utilizado
+     * \param showWeek Opção que indica se o nome do dia da semana é incluído
+     *                 (por padrão sim)
+     * \param threads Quantidade de threads (padrão 1; 0 usa todos os núcleos;
+     *                sem suporte a C++11 o trabalho é sempre feito em uma).
+     *                Na glibc, localtime_r serializa as threads em uma trava
+     *                global do fuso, então só a escrita do texto roda em
+     *                paralelo: o ganho é limitado (nenhum nos benchmarks
+     *                de test/main.cpp). Se não for possível criar uma
+     *                thread, as partes restantes são feitas na atual
+     */
+    bool format(const time_t* seconds, size_t count, DateFormat dateFormat,
+        bool showWeek=true, unsigned threads=1);
+
+    /**
+     * Retorna a quantidade de strings
+     * \return Quantidade de strings
+     */
+    size_t size() const;
+
+    /**
+     * Retorna o buffer de caracteres (sem '\\0' entre as strings)
+     * \return Ponteiro para o primeiro caractere
+     */
+    const char* getData() const;
+
+    /**
+     * Retorna o tamanho do buffer de caracteres
+     * \return Quantidade de caracteres
+     */
+    size_t getDataLength() const;
+
+    /**
+     * Retorna os offsets (size() + 1 valores, o primeiro é 0)
+     * \return Ponteiro para o primeiro offset
+     */
+    const int32_t* getOffsets() const;
+
+    /**
+     * Copia uma string da coluna
+     * \param index Posição (0 - size()-1)
+     * \param dateString String a ser preenchida
+     */
+    void getString(size_t index, string& dateString) const;
+
+private:
+    /**
+     * Caracteres de todas as strings
+     */
+    std::vector<char> data;
+
+    /**
+     * Offsets das strings em data
+     */
+    std::vector<int32_t> offsets;
+
+    /**
+     * Tamanho usado de data (data é mantido com o tamanho máximo)
+     */
+    size_t dataLength;
+};
+
+} /** namespace dateCpp */
+
+#endif /* DATECOLUMN_HPP_ */
@@ -0,0 +1,72 @@
+/**
+ * \file datecommon.h
+ * Funções internas de date.cpp compartilhadas com os módulos opcionais
+ * (não fazem parte da interface pública de date.h)
+ */
+
+#ifndef DATECOMMON_HPP_
+#define DATECOMMON_HPP_
+
+#include <ctime>
+#include "date.h"
+
+namespace dateCpp{
+
+/**
+ * Nomes dos dias da semana (0 - 6, começando pelo Domingo)
+ */
+extern const char* const weekDayNames[];
+
+/**
+ * Divisão arredondada para baixo (também para valores negativos)
+ * \return Quociente arredondado para baixo
+ * \param value Dividendo
+ * \param divisor Divisor (positivo)
+ */
+long long getFloorDivision(long long value, long long divisor);
+
+/**
+ * Calcula os dias desde 1/1/1970 de uma data do calendário gregoriano
+ * (sem fuso horário)
+ * \return Dias desde 1/1/1970 (negativo antes)
+ * \param year Ano
+ * \param month Mês (1 - 12)
+ * \param day Dia do mês
+ */
+long long getDaysFromCivil(long long year, int month, int day);
+
+/**
+ * Calcula a data do calendário gregoriano a partir dos dias desde 1/1/1970
+ * \param days Dias desde 1/1/1970
+ * \param year Ano
+ * \param month Mês (1 - 12)
+ * \param day Dia do mês
+ */
+void getCivilFromDays(long long days, long long& year, int& month, int& day);
+
+/**
+ * Coloca a data em uma estrutura tm no horário local (reentrante)
+ * \return false se não conseguir
+ * \param seconds Segundos desde 1900
+ * \param result Estrutura a ser preenchida
+ */
+bool getLocalTime(time_t seconds, tm& result);
+
+/**
+ * Retorna o horário local de um instante como se fosse UTC
+ * (instante + deslocamento UTC local)
+ * \return Segundos locais desde 1/1/1970 (o próprio instante se não conseguir)
+ * \param seconds Segundos desde 1900
+ */
+long long getLocalSeconds(time_t seconds);
+
+/**
+ * Verifica se o formato é ISO 8601 / RFC 3339
+ * \return true se for
+ * \param dateFormat Formato
+ */
+bool isIsoFormat(DateFormat dateFormat);
+
+} /** namespace dateCpp */
+
+#endif /* DATECOMMON_HPP_ */
@@ -0,0 +1,356 @@
+/**
+ * \file dateformatter.cpp
+ * Implementação do arquivo dateformatter.h
+ */
+
+#include "dateformatter.h"
+#include "datecommon.h"
+#include <cstring>
+
+namespace dateCpp{
+
+/***************************************************************************
+ * Funções auxiliares
+ ***************************************************************************/
+
+/**
+ * Verifica se o formato tem a parte da data (dia, mês e ano)
+ * \return true se tiver
+ * \param dateFormat Formato (não ISO)
+ */
+bool hasFormatterDay(DateFormat dateFormat){
+    return dateFormat != DATE_HMS && dateFormat != DATE_HMS_AMPM;
+}
+
+/**
+ * Verifica se o formato tem a parte da hora
+ * \return true se tiver
+ * \param dateFormat Formato
+ */
+bool hasFormatterTime(DateFormat dateFormat){
+    return dateFormat != DATE_DMY && dateFormat != DATE_YMD;
+}
+
+/**
+ * Verifica se o formato usa am/pm
+ * \return true se usar
+ * \param dateFormat Formato
+ */
+bool hasFormatterAmPm(DateFormat dateFormat){
+    return dateFormat == DATE_HMS_AMPM || dateFormat == DATE_DMY_HMS_AMPM
+        || dateFormat == DATE_YMD_HMS_AMPM;
+}
+
+/**
+ * Escreve um campo de hora (0 - 99)
+ * \return Posição seguinte à escrita
+ * \param buffer Destino
+ * \param value Valor (0 - 99)
+ * \param padded Se o campo tem sempre dois dígitos (formatos ISO)
+ */
+char* writeFormatterField(char* buffer, int value, bool padded){
+    if(padded || value >= 10)
+        *buffer++ = (char) ('0' + value / 10);
+    *buffer++ = (char) ('0' + value % 10);
+    return buffer;
+}
+
+/**
+ * Lê um campo de dois dígitos escrito por formatIsoDate()
+ * \return Valor (0 - 99)
+ * \param text Primeiro dígito
+ */
+int readFormatterField(const char* text){
+    return (text[0] - '0') * 10 + (text[1] - '0');
+}
+
+/**
+ * Retorna o deslocamento UTC local de um instante
+ * \return Deslocamento em segundos
+ * \param seconds Segundos desde 1900
+ */
+long long getFormatterOffset(time_t seconds){
+    return getLocalSeconds(seconds) - seconds;
+}
+
+/***************************************************************************
+ * Funções da classe DateFormatter
+ ***************************************************************************/
+
+/**
+ * Construtor personalizado
+ * \param dateFormat Indica qual o formato da string a ser utilizado
+ * \param showWeek Opção que indica se o nome do dia da semana é incluído
+ *                 (por padrão sim; ignorada nos formatos ISO 8601 / RFC 3339)
+ */
+DateFormatter::DateFormatter(DateFormat dateFormat, bool showWeek){
+    this->dateFormat = dateFormat;
+    this->showWeek = showWeek;
+    iso = isIsoFormat(dateFormat);
+    text[0] = '\0';
+    length = 0;
+    tailLength = 0;
+    year = month = day = 0;
+    hour = minute = second = millisecond = 0;
+    fullRenders = 0;
+    reset();
+}
+
+/**
+ * Formata uma data, com o mesmo texto de Date::getStringDate() (ou de
+ * formatIsoDate() nos formatos ISO 8601 / RFC 3339)
+ * \return Texto terminado em '\\0', válido até a próxima chamada (vazio
+ * se a data não puder ser convertida)
+ * \param seconds Segundos desde 1900
+ * \param milliseconds Milissegundos (0 - 999; só aparecem em DATE_RFC3339)
+ */
+const char* DateFormatter::format(time_t seconds, int milliseconds){
+
+    if(!iso)
+        milliseconds = 0;
+    else if(milliseconds < 0 || milliseconds > 999){
+        // formatIsoDate() não aceita: texto vazio
+        render(seconds, milliseconds);
+        return text;
+    }
+    else if(dateFormat != DATE_RFC3339)
+        milliseconds = 0;
+
+    if(cached && seconds >= windowStart && seconds < windowEnd){
+        if(!prepared)
+            prepare();
+        if(!checked)
+            checkWindow();
+
+        // a janela pode ter diminuído
+        if(seconds >= windowStart && seconds < windowEnd){
+            int secondsOfDay = (int) (seconds + offset - localDayStart);
+            int newHour = secondsOfDay / 3600;
+            int newMinute = secondsOfDay / 60 % 60;
+            int newSecond = secondsOfDay % 60;
+
+            // reescreve só a partir do primeiro campo que mudou
+            int level;
+            if(newHour != hour) level = 0;
+            else if(newMinute != minute) level = 1;
+            else if(newSecond != second) level = 2;
+            else if(milliseconds != millisecond) level = 3;
+            else return text;
+
+            hour = newHour;
+            minute = newMinute;
+            second = newSecond;
+            millisecond = milliseconds;
+            if(hasFormatterTime(dateFormat))
+                writeTime(level);
+            return text;
+        }
+    }
+
+    render(seconds, milliseconds);
+    return text;
+}
+
+/**
+ * Formata uma data (veja format()) e coloca em dateString
+ * \param seconds Segundos desde 1900
+ * \param dateString String a ser preenchida
+ */
+void DateFormatter::getStringDate(time_t seconds, string& dateString){
+    format(seconds);
+    dateString.assign(text, length);
+}
+
+/**
+ * Retorna o tamanho do último texto gerado
+ * \return Quantidade de caracteres (sem o '\\0')
+ */
+size_t DateFormatter::getLength() const{
+    return length;
+}
+
+/**
+ * Retorna quantas vezes a data foi formatada por completo (consultando
+ * o fuso horário)
+ * \return Quantidade de formatações completas
+ */
+size_t DateFormatter::getFullRenderCount() const{
+    return fullRenders;
+}
+
+/**
+ * Descarta a data guardada (necessário depois de mudar o fuso horário)
+ */
+void DateFormatter::reset(){
+    cached = false;
+    prepared = false;
+    checked = false;
+    windowStart = windowEnd = renderSeconds = 0;
+    offset = localDayStart = 0;
+}
+
+/**
+ * Formata a data por completo e guarda a decomposição
+ * \param seconds Segundos desde 1900
+ * \param milliseconds Milissegundos
+ */
+void DateFormatter::render(time_t seconds, int milliseconds){
+    fullRenders++;
+    cached = false;
+
+    if(iso){
+        length = formatIsoDate(seconds, milliseconds, dateFormat, text);
+        text[length] = '\0';
+
+        // datas escritas em UTC (sufixo Z) não são reaproveitadas
+        if(length == 0 || text[length - 1] == 'Z')
+            return;
+    }
+    else{
+        tm tm;
+        if(!getLocalTime(seconds, tm)){
+            length = 0;
+            text[0] = '\0';
+            return;
+        }
+
+        length = formatDate(tm, dateFormat, text, showWeek);
+        year = tm.tm_year + 1900;
+        month = tm.tm_mon + 1;
+        day = tm.tm_mday;
+        hour = tm.tm_hour;
+        minute = tm.tm_min;
+        second = tm.tm_sec;
+    }
+
+    millisecond = milliseconds;
+    renderSeconds = seconds;
+
+    // o dia local cabe em um dia para cada lado; prepare() reduz a janela
+    windowStart = seconds - 86400;
+    windowEnd = seconds + 86400;
+    cached = true;
+    prepared = false;
+}
+
+/**
+ * Calcula as posições dos campos, o deslocamento UTC e a janela do dia
+ * local da última formatação completa (só quando a data seguinte cai
+ * perto dela)
+ */
+void DateFormatter::prepare(){
+    size_t tailStart;
+    long long localDays;
+
+    if(iso){
+        // campos de largura fixa: yyyy-mm-ddThh:mm:ss ou yyyymmddThhmmss
+        size_t separator = (dateFormat != DATE_ISO8601_BASIC);
+        size_t dayPosition = 6 + 2 * separator;
+        positions[0] = dayPosition + 3;
+        positions[1] = positions[0] + 2 + separator;
+        positions[2] = positions[1] + 2 + separator;
+        positions[3] = positions[2] + 2;
+        tailStart = positions[3] + (dateFormat == DATE_RFC3339 ? 4 : 0);
+
+        localDays = getDaysFromCivil(readFormatterField(text) * 100 + readFormatterField(text + 2),
+            readFormatterField(text + 4 + separator), readFormatterField(text + dayPosition));
+        hour = readFormatterField(text + positions[0]);
+        minute = readFormatterField(text + positions[1]);
+        second = readFormatterField(text + positions[2]);
+    }
+    else{
+        localDays = getDaysFromCivil(year, month, day);
+
+        if(hasFormatterTime(dateFormat)){
+            // campos sem zeros à esquerda: procura os separadores
+            positions[0] = (hasFormatterDay(dateFormat) ? strchr(text, ' ') - text + 1 : 0);
+            positions[1] = strchr(text + positions[0], ':') - text + 1;
+            positions[2] = strchr(text + positions[1], ':') - text + 1;
+            positions[3] = positions[2] + (second >= 10 ? 2 : 1);
+            tailStart = positions[3] + (hasFormatterAmPm(dateFormat) ? 3 : 0);
+        }
+        else
+            tailStart = length;
+    }
+
+    tailLength = length - tailStart;
+    memcpy(tail, text + tailStart, tailLength);
+
+    // janela: o dia local inteiro, supondo o mesmo deslocamento UTC
+    localDayStart = localDays * 86400;
+    offset = localDayStart + hour * 3600 + minute * 60 + second - renderSeconds;
+    windowStart = (time_t) (localDayStart - offset);
+    windowEnd = windowStart + 86400;
+    prepared = true;
+    checked = false;
+}
+
+/**
+ * Reescreve os campos de hora a partir de um nível
+ * \param level 0 (hora), 1 (minutos), 2 (segundos) ou 3 (milissegundos)
+ */
+void DateFormatter::writeTime(int level){
+    bool ampm = hasFormatterAmPm(dateFormat);
+    bool separator = (dateFormat != DATE_ISO8601_BASIC);
+    char* p = text + positions[level];
+
+    if(level <= 0){
+        p = writeFormatterField(p, ampm ? (hour % 12 == 0 ? 12 : hour % 12) : hour, iso);
+        if(separator) *p++ = ':';
+        positions[1] = (size_t) (p - text);
+    }
+    if(level <= 1){
+        p = writeFormatterField(p, minute, iso);
+        if(separator) *p++ = ':';
+        positions[2] = (size_t) (p - text);
+    }
+    if(level <= 2){
+        p = writeFormatterField(p, second, iso);
+        positions[3] = (size_t) (p - text);
+    }
+
+    if(dateFormat == DATE_RFC3339){
+        *p++ = '.';
+        *p++ = (char) ('0' + millisecond / 100);
+        p = writeFormatterField(p, millisecond % 100, true);
+    }
+    if(ampm){
+        *p++ = ' ';
+        memcpy(p, hour < 12 ? AM : PM, 2);
+        p += 2;
+    }
+
+    // dia da semana ou deslocamento UTC não mudam dentro da janela
+    memcpy(p, tail, tailLength);
+    p += tailLength;
+    *p = '\0';
+    length = (size_t) (p - text);
+}
+
+/**
+ * Confirma que o deslocamento UTC é o mesmo em toda a janela guardada,
+ * reduzindo-a à hora ou ao minuto da data guardada se não for
+ */
+void DateFormatter::checkWindow(){
+    checked = true;
+
+    if(getFormatterOffset(windowStart) == offset && getFormatterOffset(windowEnd - 1) == offset)
+        return;
+
+    // dia com transição de horário de verão
+    long long local = renderSeconds + offset;
+    const long long spans[] = {3600, 60};
+    for(int i = 0; i < 2; i++){
+        windowStart = (time_t) (local - (local - localDayStart) % spans[i] - offset);
+        windowEnd = windowStart + (time_t) spans[i];
+
+        if(getFormatterOffset(windowStart) == offset && getFormatterOffset(windowEnd - 1) == offset)
+            return;
+    }
+
+    // só a própria data guardada
+    windowStart = renderSeconds;
+    windowEnd = renderSeconds + 1;
+}
+
+} /** namespace dateCpp */
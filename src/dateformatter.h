@@ -0,0 +1,199 @@
+/**
+ * \file dateformatter.h
+ * Módulo que formata sequências de timestamps (quase) ordenados
+ * reaproveitando a data anterior
+ */
+
+#ifndef DATEFORMATTER_HPP_
+#define DATEFORMATTER_HPP_
+
+#include <ctime>
+#include <cstddef>
+#include <string>
+#include "date.h"
+
+namespace dateCpp{
+
+/**
+ * Classe que formata datas em um formato fixo, guardando a última data
+ * decomposta e o texto gerado<BR>
+ * Enquanto a próxima data cair no mesmo dia local (sem mudança de
+ * deslocamento UTC), apenas os campos finais que mudaram (hora, minutos,
+ * segundos) são reescritos, sem consultar o fuso horário. Saltos para fora
+ * do dia e transições de horário de verão geram uma formatação completa,
+ * alguns por cento mais lenta que formatDate(): em datas sem ordem, use
+ * formatDate(). Depois de mudar o fuso (TZ), chame reset().
+ */
+class DateFormatter {
+public:
+
+    /**
+     * Construtor personalizado
+     * \param dateFormat Indica qual o formato da string a ser utilizado
+     * \param showWeek Opção que indica se o nome do dia da semana é incluído
+     *                 (por padrão sim; ignorada nos formatos ISO 8601 / RFC 3339)
+     */
+    DateFormatter(DateFormat dateFormat, bool showWeek=true);
+
+    /**
+     * Formata uma data, com o mesmo texto de Date::getStringDate() (ou de
+     * formatIsoDate() nos formatos ISO 8601 / RFC 3339)
+     * \return Texto terminado em '\\0', válido até a próxima chamada (vazio
+     * se a data não puder ser convertida)
+     * \param seconds Segundos desde 1900
+     * \param milliseconds Milissegundos (0 - 999; só aparecem em DATE_RFC3339)
+     */
+    const char* format(time_t seconds, int milliseconds=0);
+
+    /**
+     * Formata uma data (veja format()) e coloca em dateString
+     * \param seconds Segundos desde 1900
+     * \param dateString String a ser preenchida
+     */
+    void getStringDate(time_t seconds, string& dateString);
+
+    /**
+     * Retorna o tamanho do último texto gerado
+     * \return Quantidade de caracteres (sem o '\\0')
+     */
+    size_t getLength() const;
+
+    /**
+     * Retorna quantas vezes a data foi formatada por completo (consultando
+     * o fuso horário)
+     * \return Quantidade de formatações completas
+     */
+    size_t getFullRenderCount() const;
+
+    /**
+     * Descarta a data guardada (necessário depois de mudar o fuso horário)
+     */
+    void reset();
+
+private:
+    /**
+     * Formata a data por completo e guarda a decomposição
+     * \param seconds Segundos desde 1900
+     * \param milliseconds Milissegundos
+     */
+    void render(time_t seconds, int milliseconds);
+
+    /**
+     * Calcula as posições dos campos, o deslocamento UTC e a janela do dia
+     * local da última formatação completa (só quando a data seguinte cai
+     * perto dela)
+     */
+    void prepare();
+
+    /**
+     * Reescreve os campos de hora a partir de um nível
+     * \param level 0 (hora), 1 (minutos), 2 (segundos) ou 3 (milissegundos)
+     */
+    void writeTime(int level);
+
+    /**
+     * Confirma que o deslocamento UTC é o mesmo em toda a janela guardada,
+     * reduzindo-a à hora ou ao minuto da data guardada se não for
+     */
+    void checkWindow();
+
+    /**
+     * Formato usado
+     */
+    DateFormat dateFormat;
+
+    /**
+     * Se o nome do dia da semana é incluído
+     */
+    bool showWeek;
+
+    /**
+     * Se o formato é ISO 8601 / RFC 3339
+     */
+    bool iso;
+
+    /**
+     * Último texto gerado
+     */
+    char text[DATE_MAX_LENGTH + 1];
+
+    /**
+     * Tamanho do último texto gerado
+     */
+    size_t length;
+
+    /**
+     * Texto depois dos campos de hora (dia da semana ou deslocamento UTC)
+     */
+    char tail[DATE_MAX_LENGTH + 1];
+
+    /**
+     * Tamanho de tail
+     */
+    size_t tailLength;
+
+    /**
+     * Posições no texto da hora, dos minutos, dos segundos e do fim dos
+     * segundos
+     */
+    size_t positions[4];
+
+    /**
+     * Se a janela [windowStart, windowEnd) está em uso
+     */
+    bool cached;
+
+    /**
+     * Se prepare() já foi chamada para a última formatação completa
+     */
+    bool prepared;
+
+    /**
+     * Se o deslocamento UTC já foi confirmado em toda a janela
+     */
+    bool checked;
+
+    /**
+     * Início da janela em que a data guardada pode ser reaproveitada
+     */
+    time_t windowStart;
+
+    /**
+     * Fim (exclusivo) da janela
+     */
+    time_t windowEnd;
+
+    /**
+     * Instante da última formatação completa
+     */
+    time_t renderSeconds;
+
+    /**
+     * Deslocamento UTC da janela, em segundos
+     */
+    long long offset;
+
+    /**
+     * Início do dia local guardado (horário local lido como UTC)
+     */
+    long long localDayStart;
+
+    /**
+     * Dia local da última formatação completa (formatos não ISO)
+     */
+    int year, month, day;
+
+    /**
+     * Campos de hora do último texto gerado
+     */
+    int hour, minute, second, millisecond;
+
+    /**
+     * Quantidade de formatações completas
+     */
+    size_t fullRenders;
+};
+
+} /** namespace dateCpp */
+
+#endif /* DATEFORMATTER_HPP_ */
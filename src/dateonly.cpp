@@ -0,0 +1,316 @@
+/**
+ * \file dateonly.cpp
+ * Implementação do arquivo dateonly.h
+ */
+
+#include "dateonly.h"
+#include "datecommon.h"
+
+namespace dateCpp{
+
+/***************************************************************************
+ * Funções auxiliares
+ ***************************************************************************/
+
+/**
+ * Calcula o dia local (dias desde 1/1/1970) de um instante
+ * \return Dias desde 1/1/1970
+ * \param seconds Segundos desde 1900
+ */
+long long getLocalDays(time_t seconds){
+    // arredonda para baixo antes de 1970
+    return getFloorDivision(getLocalSeconds(seconds), 86400);
+}
+
+/**
+ * Verifica se um valor cabe em 32 bits com sinal
+ * \return true se couber
+ * \param value Valor
+ */
+bool fitsInInt32(long long value){
+    return value >= -2147483647LL - 1 && value <= 2147483647LL;
+}
+
+/***************************************************************************
+ * Funções da classe DateOnly
+ ***************************************************************************/
+
+/**
+ * Construtor padrão<BR>
+ * Configura para o dia atual (horário local)
+ */
+DateOnly::DateOnly(){
+    setDate();
+}
+
+/**
+ * Construtor personalizado<BR>
+ * Configura para um dia especificado (o dia atual se não for válido)
+ * \param day Dia do mês
+ * \param month Mês
+ * \param year Ano
+ */
+DateOnly::DateOnly(int day, int month, int year){
+    // se o dia especificado não for válido...
+    if(!setDate(day, month, year))
+        // configura para o dia atual
+        setDate();
+}
+
+/**
+ * Construtor personalizado<BR>
+ * Configura para o dia local de uma data
+ * \param date Data
+ */
+DateOnly::DateOnly(Date& date){
+    if(!setDate(date))
+        setDate();
+}
+
+/**
+ * Configura para o dia atual (horário local)
+ */
+void DateOnly::setDate(){
+    days = (int32_t) getLocalDays(time(0));
+}
+
+/**
+ * Configura o dia
+ * \return false se não conseguir (o dia não é válido)
+ * \param day Dia do mês
+ * \param month Mês
+ * \param year Ano
+ */
+bool DateOnly::setDate(int day, int month, int year){
+    if(!validateDate(day, month, year))
+        return false;
+
+    long long result = getDaysFromCivil(year, month, day);
+    if(!fitsInInt32(result))
+        return false;
+
+    days = (int32_t) result;
+    return true;
+}
+
+/**
+ * Configura para o dia local de uma data
+ * \return false se não conseguir
+ * \param date Data
+ */
+bool DateOnly::setDate(Date& date){
+    long long result = getLocalDays(date.getDateInSeconds());
+    if(!fitsInInt32(result))
+        return false;
+
+    days = (int32_t) result;
+    return true;
+}
+
+/**
+ * Configura o dia a partir dos dias desde 1/1/1970
+ * \param days Dias desde 1/1/1970 (negativo antes)
+ */
+void DateOnly::setDateInDays(int32_t days){
+    this->days = days;
+}
+
+/**
+ * Retorna os dias desde 1/1/1970
+ * \return Dias desde 1/1/1970 (negativo antes)
+ */
+int32_t DateOnly::getDateInDays() const{
+    return days;
+}
+
+/**
+ * Configura date para a meia-noite local deste dia
+ * \return false se não conseguir
+ * \param date Data a ser configurada
+ */
+bool DateOnly::getDate(Date& date) const{
+    long long year;
+    int month, day;
+    getCivilFromDays(days, year, month, day);
+
+    return date.setDate(day, month, (int) year);
+}
+
+/**
+ * Retorna um componente do dia (veja Date::getDateComponent())
+ * \return -1 se não conseguir retornar o solicitado (componentes de hora)
+ * \param dateComponent MDAY, YDAY, WDAY, MONTH ou YEAR
+ */
+int DateOnly::getDateComponent(DateComponent dateComponent) const{
+    tm tm;
+    getTm(tm);
+
+    switch(dateComponent){
+    case MDAY:
+        return tm.tm_mday;
+    case YDAY:
+        return tm.tm_yday;
+    case WDAY:
+        return tm.tm_wday;
+    case MONTH:
+        return (tm.tm_mon + 1);
+    case YEAR:
+        return (tm.tm_year + 1900);
+    default:
+        return -1;
+    }
+}
+
+/**
+ * Gera uma string e coloca em dateString (veja Date::getStringDate())
+ * \param dateFormat DATE_DMY ou DATE_YMD (outros formatos geram string vazia)
+ * \param dateString String a ser preenchida
+ * \param showWeek Opção que indica se o nome do dia da semana é incluído
+ *                 (por padrão sim)
+ */
+void DateOnly::getStringDate(DateFormat dateFormat, string& dateString, bool showWeek) const{
+    if(dateFormat != DATE_DMY && dateFormat != DATE_YMD){
+        dateString.clear();
+        return;
+    }
+
+    tm tm;
+    getTm(tm);
+
+    char buffer[DATE_MAX_LENGTH + 1];
+    dateString.assign(buffer, formatDate(tm, dateFormat, buffer, showWeek));
+}
+
+/**
+ * Gera uma string do dia da semana e coloca em weekString
+ * \param weekString String a ser preenchida
+ */
+void DateOnly::getStringWeek(string& weekString) const{
+    weekString = weekDayNames[getDateComponent(WDAY)];
+}
+
+/**
+ * Adiciona (ou subtrai) um valor em uma componente do dia, como
+ * Date::addDateComponent() (31/1 + 1 mês = 3/3 ou 2/3)
+ * \return false se não conseguir (componentes de hora ou resultado fora
+ * de 32 bits)
+ * \param dateComponent MDAY (dias), MONTH ou YEAR; YDAY e WDAY, como em
+ *                      Date, retornam true sem alterar o dia
+ * \param value Valor a ser adicionado (ou subtraído)
+ * \param add Se deverá adicionar ou subtrair (adiciona por padrão)
+ */
+bool DateOnly::addDateComponent(DateComponent dateComponent, int value, bool add){
+    long long amount = (add ? (long long) value : -(long long) value);
+    long long year, result;
+    int month, day;
+
+    switch(dateComponent){
+    case MDAY:
+        result = days + amount;
+        break;
+    case YDAY:
+    case WDAY:
+        // como em Date: o mktime ignora tm_yday e tm_wday
+        return true;
+    case MONTH:{
+        getCivilFromDays(days, year, month, day);
+        long long months = year * 12 + (month - 1) + amount;
+        long long newYear = getFloorDivision(months, 12);
+        // dias além do fim do mês passam para o mês seguinte, como no mktime
+        result = getDaysFromCivil(newYear, (int) (months - newYear * 12) + 1, day);
+        break;
+    }
+    case YEAR:
+        getCivilFromDays(days, year, month, day);
+        result = getDaysFromCivil(year + amount, month, day);
+        break;
+    default:
+        return false;
+    }
+
+    if(!fitsInInt32(result))
+        return false;
+
+    days = (int32_t) result;
+    return true;
+}
+
+/**
+ * Imprime o dia no prompt
+ * \param dateFormat DATE_DMY ou DATE_YMD
+ * \param showWeek Se o nome do dia da semana deve ser mostrado
+ *                  (sim por padrão)
+ */
+void DateOnly::printDate(DateFormat dateFormat, bool showWeek) const{
+    string dateString;
+    getStringDate(dateFormat, dateString, showWeek);
+
+    cout<<dateString<<endl;
+}
+
+/**
+ * Verifica se um dia é válido
+ * \return false se não for
+ * \param day Dia do mês
+ * \param month Mês
+ * \param year Ano
+ */
+bool DateOnly::validateDate(int day, int month, int year) const{
+    if(month < 1 || month > 12 || day < 1 || day > 31)
+        return false;
+
+    // o dia tem que voltar igual (31/4 viraria 1/5)
+    long long checkYear;
+    int checkMonth, checkDay;
+    getCivilFromDays(getDaysFromCivil(year, month, day), checkYear, checkMonth, checkDay);
+
+    return checkDay == day && checkMonth == month;
+}
+
+/**
+ * Compara dois dias
+ * \return true se forem iguais
+ * \param other Outro dia
+ */
+bool DateOnly::operator==(const DateOnly& other) const{
+    return days == other.days;
+}
+
+/**
+ * Compara dois dias
+ * \return true se forem diferentes
+ * \param other Outro dia
+ */
+bool DateOnly::operator!=(const DateOnly& other) const{
+    return days != other.days;
+}
+
+/**
+ * Compara dois dias
+ * \return true se este vier antes de other
+ * \param other Outro dia
+ */
+bool DateOnly::operator<(const DateOnly& other) const{
+    return days < other.days;
+}
+
+/**
+ * Decompõe o dia em uma estrutura tm (sem campos de hora)
+ * \param result Estrutura a ser preenchida
+ */
+void DateOnly::getTm(tm& result) const{
+    long long year;
+    int month, day;
+    getCivilFromDays(days, year, month, day);
+
+    result.tm_mday = day;
+    result.tm_mon = month - 1;
+    result.tm_year = (int) (year - 1900);
+    result.tm_yday = (int) (days - getDaysFromCivil(year, 1, 1));
+    // 1/1/1970 foi uma quinta-feira
+    result.tm_wday = (int) (((days + 4) % 7 + 7) % 7);
+    result.tm_hour = result.tm_min = result.tm_sec = 0;
+    result.tm_isdst = -1;
+}
+
+} /** namespace dateCpp */
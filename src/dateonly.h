@@ -0,0 +1,173 @@
+/**
+ * \file dateonly.h
+ * Módulo que guarda apenas um dia do calendário em 32 bits
+ */
+
+#ifndef DATEONLY_HPP_
+#define DATEONLY_HPP_
+
+#include <string>
+#include <stdint.h>
+#include "date.h"
+
+namespace dateCpp{
+
+/**
+ * Classe que guarda um dia do calendário gregoriano (dias desde 1/1/1970,
+ * 4 bytes, sem alocação)<BR>
+ * Não depende de fuso horário; só as conversões de/para Date usam o horário
+ * local
+ */
+class DateOnly {
+public:
+
+    /**
+     * Construtor padrão<BR>
+     * Configura para o dia atual (horário local)
+     */
+    DateOnly();
+
+    /**
+     * Construtor personalizado<BR>
+     * Configura para um dia especificado (o dia atual se não for válido)
+     * \param day Dia do mês
+     * \param month Mês
+     * \param year Ano
+     */
+    DateOnly(int day, int month, int year);
+
+    /**
+     * Construtor personalizado<BR>
+     * Configura para o dia local de uma data
+     * \param date Data
+     */
+    explicit DateOnly(Date& date);
+
+    /**
+     * Configura para o dia atual (horário local)
+     */
+    void setDate();
+
+    /**
+     * Configura o dia
+     * \return false se não conseguir (o dia não é válido)
+     * \param day Dia do mês
+     * \param month Mês
+     * \param year Ano
+     */
+    bool setDate(int day, int month, int year);
+
+    /**
+     * Configura para o dia local de uma data
+     * \return false se não conseguir
+     * \param date Data
+     */
+    bool setDate(Date& date);
+
+    /**
+     * Configura o dia a partir dos dias desde 1/1/1970
+     * \param days Dias desde 1/1/1970 (negativo antes)
+     */
+    void setDateInDays(int32_t days);
+
+    /**
+     * Retorna os dias desde 1/1/1970
+     * \return Dias desde 1/1/1970 (negativo antes)
+     */
+    int32_t getDateInDays() const;
+
+    /**
+     * Configura date para a meia-noite local deste dia
+     * \return false se não conseguir
+     * \param date Data a ser configurada
+     */
+    bool getDate(Date& date) const;
+
+    /**
+     * Retorna um componente do dia (veja Date::getDateComponent())
+     * \return -1 se não conseguir retornar o solicitado (componentes de hora)
+     * \param dateComponent MDAY, YDAY, WDAY, MONTH ou YEAR
+     */
+    int getDateComponent(DateComponent dateComponent) const;
+
+    /**
+     * Gera uma string e coloca em dateString (veja Date::getStringDate())
+     * \param dateFormat DATE_DMY ou DATE_YMD (outros formatos geram string vazia)
+     * \param dateString String a ser preenchida
+     * \param showWeek Opção que indica se o nome do dia da semana é incluído
+     *                 (por padrão sim)
+     */
+    void getStringDate(DateFormat dateFormat, string& dateString, bool showWeek=true) const;
+
+    /**
+     * Gera uma string do dia da semana e coloca em weekString
+     * \param weekString String a ser preenchida
+     */
+    void getStringWeek(string& weekString) const;
+
+    /**
+     * Adiciona (ou subtrai) um valor em uma componente do dia, como
+     * Date::addDateComponent() (31/1 + 1 mês = 3/3 ou 2/3)
+     * \return false se não conseguir (componentes de hora ou resultado fora
+     * de 32 bits)
+     * \param dateComponent MDAY (dias), MONTH ou YEAR; YDAY e WDAY, como em
+     *                      Date, retornam true sem alterar o dia
+     * \param value Valor a ser adicionado (ou subtraído)
+     * \param add Se deverá adicionar ou subtrair (adiciona por padrão)
+     */
+    bool addDateComponent(DateComponent dateComponent, int value, bool add=true);
+
+    /**
+     * Imprime o dia no prompt
+     * \param dateFormat DATE_DMY ou DATE_YMD
+     * \param showWeek Se o nome do dia da semana deve ser mostrado
+     *                  (sim por padrão)
+     */
+    void printDate(DateFormat dateFormat, bool showWeek=true) const;
+
+    /**
+     * Verifica se um dia é válido
+     * \return false se não for
+     * \param day Dia do mês
+     * \param month Mês
+     * \param year Ano
+     */
+    bool validateDate(int day, int month, int year) const;
+
+    /**
+     * Compara dois dias
+     * \return true se forem iguais
+     * \param other Outro dia
+     */
+    bool operator==(const DateOnly& other) const;
+
+    /**
+     * Compara dois dias
+     * \return true se forem diferentes
+     * \param other Outro dia
+     */
+    bool operator!=(const DateOnly& other) const;
+
+    /**
+     * Compara dois dias
+     * \return true se este vier antes de other
+     * \param other Outro dia
+     */
+    bool operator<(const DateOnly& other) const;
+
+private:
+    /**
+     * Decompõe o dia em uma estrutura tm (sem campos de hora)
+     * \param result Estrutura a ser preenchida
+     */
+    void getTm(tm& result) const;
+
+    /**
+     * Dias desde 1/1/1970
+     */
+    int32_t days;
+};
+
+} /** namespace dateCpp */
+
+#endif /* DATEONLY_HPP_ */
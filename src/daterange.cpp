@@ -0,0 +1,488 @@
+/**
+ * \file daterange.cpp
+ * Implementação do arquivo daterange.h
+ */
+
+#include "daterange.h"
+#include "datecommon.h"
+#include <algorithm>
+
+namespace dateCpp{
+
+/***************************************************************************
+ * Funções auxiliares
+ ***************************************************************************/
+
+/**
+ * Calcula a próxima virada do calendário local depois de um horário local
+ * \return Horário local da virada, em segundos locais desde 1/1/1970
+ * \param local Horário local, em segundos locais desde 1/1/1970
+ * \param dateComponent HOUR, MDAY, MONTH ou YEAR
+ */
+long long getNextLocalBoundary(long long local, DateComponent dateComponent){
+    long long days = getFloorDivision(local, 86400);
+    long long year;
+    int month, day;
+
+    switch(dateComponent){
+    case HOUR:
+        return (getFloorDivision(local, 3600) + 1) * 3600;
+    case MONTH:
+        getCivilFromDays(days, year, month, day);
+        if(month == 12)
+            return getDaysFromCivil(year + 1, 1, 1) * 86400;
+        return getDaysFromCivil(year, month + 1, 1) * 86400;
+    case YEAR:
+        getCivilFromDays(days, year, month, day);
+        return getDaysFromCivil(year + 1, 1, 1) * 86400;
+    default:
+        return (days + 1) * 86400;
+    }
+}
+
+/**
+ * Acha o primeiro instante depois de current cujo horário local alcança
+ * boundary<BR>
+ * No caso comum (sem mudança de fuso até a virada) basta uma consulta ao
+ * fuso; perto de transições de horário de verão faz uma busca binária
+ * \return Instante da virada (no máximo limit)
+ * \param boundary Horário local da virada
+ * \param current Instante atual (horário local anterior à virada)
+ * \param offset Deslocamento UTC em current
+ * \param limit Maior instante aceito
+ */
+time_t getLocalBoundaryInstant(long long boundary, time_t current, long long offset, time_t limit){
+
+    // supõe o mesmo deslocamento de current
+    long long first = boundary - offset;
+    if(first >= limit)
+        return limit;
+    long long firstLocal = getLocalSeconds((time_t) first);
+    if(firstLocal == boundary)
+        return (time_t) first;
+
+    // o deslocamento mudou: tenta o deslocamento encontrado
+    long long second = boundary - (firstLocal - first);
+    long long secondLocal = getLocalSeconds((time_t) second);
+    if(secondLocal == boundary && second > current
+        && getLocalSeconds((time_t) (second - 1)) < boundary)
+        return (time_t) std::min<long long>(second, limit);
+
+    // a virada cai dentro da transição: busca binária em (current, high]
+    long long low = current;
+    long long high;
+    if(firstLocal >= boundary) high = first;
+    else if(secondLocal >= boundary && second > current) high = second;
+    else return limit;
+
+    while(high - low > 1){
+        long long middle = low + (high - low) / 2;
+        if(getLocalSeconds((time_t) middle) >= boundary) high = middle;
+        else low = middle;
+    }
+
+    return (time_t) std::min<long long>(high, limit);
+}
+
+/**
+ * Compara intervalos pelo início (para ordenação)
+ * \return true se a começa antes de b
+ * \param a Intervalo
+ * \param b Intervalo
+ */
+bool isRangeStartBefore(const DateRange& a, const DateRange& b){
+    return a.getStart() < b.getStart();
+}
+
+/**
+ * Acrescenta um intervalo ao fim de um vetor ordenado, unindo-o ao último
+ * se eles se tocarem
+ * \param ranges Vetor ordenado
+ * \param range Intervalo que não começa antes do último
+ */
+void appendRange(std::vector<DateRange>& ranges, const DateRange& range){
+    if(range.isEmpty())
+        return;
+
+    if(!ranges.empty() && range.getStart() <= ranges.back().getEnd()){
+        if(range.getEnd() > ranges.back().getEnd())
+            ranges.back() = DateRange(ranges.back().getStart(), range.getEnd());
+    }
+    else
+        ranges.push_back(range);
+}
+
+/***************************************************************************
+ * Funções da classe DateRange
+ ***************************************************************************/
+
+/**
+ * Construtor padrão<BR>
+ * Cria um intervalo vazio
+ */
+DateRange::DateRange(){
+    start = 0;
+    end = 0;
+}
+
+/**
+ * Construtor personalizado<BR>
+ * Cria o intervalo [start, end)
+ * \param start Início, em segundos desde 1900 (incluído)
+ * \param end Fim, em segundos desde 1900 (excluído)
+ */
+DateRange::DateRange(time_t start, time_t end){
+    this->start = start;
+    this->end = end;
+}
+
+/**
+ * Construtor personalizado<BR>
+ * Cria o intervalo [start, end)
+ * \param start Data de início (incluída)
+ * \param end Data de fim (excluída)
+ */
+DateRange::DateRange(Date& start, Date& end){
+    this->start = start.getDateInSeconds();
+    this->end = end.getDateInSeconds();
+}
+
+/**
+ * Retorna o início do intervalo
+ * \return Segundos desde 1900
+ */
+time_t DateRange::getStart() const{
+    return start;
+}
+
+/**
+ * Retorna o fim do intervalo (excluído)
+ * \return Segundos desde 1900
+ */
+time_t DateRange::getEnd() const{
+    return end;
+}
+
+/**
+ * Retorna a duração do intervalo
+ * \return Segundos (0 se vazio)
+ */
+time_t DateRange::getDuration() const{
+    return isEmpty() ? 0 : end - start;
+}
+
+/**
+ * Verifica se o intervalo é vazio
+ * \return true se for
+ */
+bool DateRange::isEmpty() const{
+    return end <= start;
+}
+
+/**
+ * Verifica se uma data está no intervalo
+ * \return true se start <= seconds < end
+ * \param seconds Segundos desde 1900
+ */
+bool DateRange::contains(time_t seconds) const{
+    return start <= seconds && seconds < end;
+}
+
+/**
+ * Verifica se dois intervalos têm alguma data em comum
+ * \return true se tiverem
+ * \param range Outro intervalo
+ */
+bool DateRange::overlaps(const DateRange& range) const{
+    return !isEmpty() && !range.isEmpty() && start < range.end && range.start < end;
+}
+
+/**
+ * Divide o intervalo nas viradas do calendário local (hora, dia, mês
+ * ou ano)<BR>
+ * Cada virada é o primeiro segundo em que o horário local alcança a
+ * nova hora, dia, mês ou ano; é calculada com aritmética de calendário
+ * e uma consulta ao fuso, sem addDateComponent
+ * \return false se a componente não for HOUR, MDAY, MONTH ou YEAR
+ * \param dateComponent Componente da virada (HOUR, MDAY, MONTH ou YEAR)
+ * \param parts Vetor onde as partes são acrescentadas, em ordem
+ */
+bool DateRange::split(DateComponent dateComponent, std::vector<DateRange>& parts) const{
+
+    if(dateComponent != HOUR && dateComponent != MDAY && dateComponent != MONTH
+        && dateComponent != YEAR)
+        return false;
+
+    time_t current = start;
+    while(current < end){
+        // horário local atual e a próxima virada
+        long long local = getLocalSeconds(current);
+        long long boundary = getNextLocalBoundary(local, dateComponent);
+        time_t next = getLocalBoundaryInstant(boundary, current, local - current, end);
+
+        parts.push_back(DateRange(current, next));
+        current = next;
+    }
+
+    return true;
+}
+
+/**
+ * Compara início e fim
+ * \return true se forem iguais
+ * \param range Outro intervalo
+ */
+bool DateRange::operator==(const DateRange& range) const{
+    return start == range.start && end == range.end;
+}
+
+/***************************************************************************
+ * Funções da classe DateRangeSet
+ ***************************************************************************/
+
+/**
+ * Construtor padrão<BR>
+ * Cria um conjunto vazio
+ */
+DateRangeSet::DateRangeSet(){
+}
+
+/**
+ * Construtor personalizado<BR>
+ * Cria o conjunto a partir de intervalos em qualquer ordem, com
+ * sobreposições e vazios (O(n log n))
+ * \param ranges Intervalos
+ */
+DateRangeSet::DateRangeSet(const std::vector<DateRange>& ranges){
+    std::vector<DateRange> sorted;
+    sorted.reserve(ranges.size());
+
+    // descarta os vazios
+    for(size_t i = 0; i < ranges.size(); i++)
+        if(!ranges[i].isEmpty())
+            sorted.push_back(ranges[i]);
+
+    std::sort(sorted.begin(), sorted.end(), isRangeStartBefore);
+
+    // une os que se sobrepõem ou se tocam, em uma passada
+    this->ranges.reserve(sorted.size());
+    for(size_t i = 0; i < sorted.size(); i++)
+        appendRange(this->ranges, sorted[i]);
+}
+
+/**
+ * Acrescenta um intervalo, unindo-o aos que ele sobrepõe
+ * \param range Intervalo
+ */
+void DateRangeSet::add(const DateRange& range){
+    if(range.isEmpty())
+        return;
+
+    // primeiro intervalo que toca ou sobrepõe range
+    size_t first = findEndingAfter(range.getStart() - 1);
+    size_t last = first;
+    time_t start = range.getStart();
+    time_t end = range.getEnd();
+
+    while(last < ranges.size() && ranges[last].getStart() <= range.getEnd()){
+        start = std::min(start, ranges[last].getStart());
+        end = std::max(end, ranges[last].getEnd());
+        last++;
+    }
+
+    // troca [first, last) pelo intervalo unido
+    if(first == last)
+        ranges.insert(ranges.begin() + first, DateRange(start, end));
+    else{
+        ranges[first] = DateRange(start, end);
+        ranges.erase(ranges.begin() + first + 1, ranges.begin() + last);
+    }
+}
+
+/**
+ * Esvazia o conjunto
+ */
+void DateRangeSet::clear(){
+    ranges.clear();
+}
+
+/**
+ * Retorna a quantidade de intervalos
+ * \return Quantidade de intervalos
+ */
+size_t DateRangeSet::size() const{
+    return ranges.size();
+}
+
+/**
+ * Verifica se o conjunto é vazio
+ * \return true se for
+ */
+bool DateRangeSet::isEmpty() const{
+    return ranges.empty();
+}
+
+/**
+ * Retorna um intervalo
+ * \return Intervalo na posição index (em ordem de início)
+ * \param index Posição (0 - size()-1)
+ */
+const DateRange& DateRangeSet::getRange(size_t index) const{
+    return ranges[index];
+}
+
+/**
+ * Retorna todos os intervalos, em ordem
+ * \return Vetor de intervalos
+ */
+const std::vector<DateRange>& DateRangeSet::getRanges() const{
+    return ranges;
+}
+
+/**
+ * Retorna a soma das durações dos intervalos
+ * \return Segundos
+ */
+time_t DateRangeSet::getDuration() const{
+    time_t duration = 0;
+    for(size_t i = 0; i < ranges.size(); i++)
+        duration += ranges[i].getDuration();
+    return duration;
+}
+
+/**
+ * Verifica se uma data está em algum intervalo (O(log n))
+ * \return true se estiver
+ * \param seconds Segundos desde 1900
+ */
+bool DateRangeSet::contains(time_t seconds) const{
+    size_t index = findEndingAfter(seconds);
+    return index < ranges.size() && ranges[index].getStart() <= seconds;
+}
+
+/**
+ * Verifica se um intervalo está inteiramente no conjunto (O(log n))
+ * \return true se estiver (intervalos vazios nunca estão)
+ * \param range Intervalo
+ */
+bool DateRangeSet::contains(const DateRange& range) const{
+    if(range.isEmpty())
+        return false;
+
+    size_t index = findEndingAfter(range.getStart());
+    return index < ranges.size() && ranges[index].getStart() <= range.getStart()
+        && range.getEnd() <= ranges[index].getEnd();
+}
+
+/**
+ * Verifica se um intervalo tem alguma data no conjunto (O(log n))
+ * \return true se tiver
+ * \param range Intervalo
+ */
+bool DateRangeSet::overlaps(const DateRange& range) const{
+    if(range.isEmpty())
+        return false;
+
+    size_t index = findEndingAfter(range.getStart());
+    return index < ranges.size() && ranges[index].getStart() < range.getEnd();
+}
+
+/**
+ * Calcula a união com outro conjunto (O(n + m))
+ * \param other Outro conjunto
+ * \param result Conjunto a ser preenchido (pode ser um dos operandos)
+ */
+void DateRangeSet::getUnion(const DateRangeSet& other, DateRangeSet& result) const{
+    const std::vector<DateRange>& a = ranges;
+    const std::vector<DateRange>& b = other.ranges;
+    std::vector<DateRange> merged;
+    merged.reserve(a.size() + b.size());
+
+    // intercala pelo início, unindo o que se toca
+    size_t i = 0, j = 0;
+    while(i < a.size() || j < b.size()){
+        if(j == b.size() || (i < a.size() && a[i].getStart() <= b[j].getStart()))
+            appendRange(merged, a[i++]);
+        else
+            appendRange(merged, b[j++]);
+    }
+
+    result.ranges.swap(merged);
+}
+
+/**
+ * Calcula a interseção com outro conjunto (O(n + m))
+ * \param other Outro conjunto
+ * \param result Conjunto a ser preenchido (pode ser um dos operandos)
+ */
+void DateRangeSet::getIntersection(const DateRangeSet& other, DateRangeSet& result) const{
+    const std::vector<DateRange>& a = ranges;
+    const std::vector<DateRange>& b = other.ranges;
+    std::vector<DateRange> common;
+
+    size_t i = 0, j = 0;
+    while(i < a.size() && j < b.size()){
+        time_t start = std::max(a[i].getStart(), b[j].getStart());
+        time_t end = std::min(a[i].getEnd(), b[j].getEnd());
+        if(start < end)
+            common.push_back(DateRange(start, end));
+
+        // avança o que termina primeiro
+        if(a[i].getEnd() < b[j].getEnd()) i++;
+        else j++;
+    }
+
+    result.ranges.swap(common);
+}
+
+/**
+ * Calcula a diferença (este conjunto menos o outro) (O(n + m))
+ * \param other Outro conjunto
+ * \param result Conjunto a ser preenchido (pode ser um dos operandos)
+ */
+void DateRangeSet::getDifference(const DateRangeSet& other, DateRangeSet& result) const{
+    const std::vector<DateRange>& a = ranges;
+    const std::vector<DateRange>& b = other.ranges;
+    std::vector<DateRange> remaining;
+
+    size_t j = 0;
+    for(size_t i = 0; i < a.size(); i++){
+        time_t current = a[i].getStart();
+
+        // pula os que terminam antes deste intervalo
+        while(j < b.size() && b[j].getEnd() <= current)
+            j++;
+
+        // recorta os que se sobrepõem a este intervalo
+        size_t k = j;
+        while(k < b.size() && b[k].getStart() < a[i].getEnd()){
+            if(b[k].getStart() > current)
+                remaining.push_back(DateRange(current, b[k].getStart()));
+            current = std::max(current, b[k].getEnd());
+            k++;
+        }
+
+        if(current < a[i].getEnd())
+            remaining.push_back(DateRange(current, a[i].getEnd()));
+    }
+
+    result.ranges.swap(remaining);
+}
+
+/**
+ * Posição do primeiro intervalo que termina depois de seconds
+ * \return Posição (size() se nenhum)
+ * \param seconds Segundos desde 1900
+ */
+size_t DateRangeSet::findEndingAfter(time_t seconds) const{
+    // os fins também estão em ordem, pois os intervalos não se sobrepõem
+    size_t low = 0, high = ranges.size();
+    while(low < high){
+        size_t middle = low + (high - low) / 2;
+        if(ranges[middle].getEnd() > seconds) high = middle;
+        else low = middle + 1;
+    }
+    return low;
+}
+
+} /** namespace dateCpp */
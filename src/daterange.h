@@ -0,0 +1,237 @@
+/**
+ * \file daterange.h
+ * Módulo de intervalos de datas [início, fim) e de conjuntos de intervalos
+ * com união, interseção e diferença
+ */
+
+#ifndef DATERANGE_HPP_
+#define DATERANGE_HPP_
+
+#include <ctime>
+#include <cstddef>
+#include <vector>
+#include "date.h"
+
+namespace dateCpp{
+
+/**
+ * Classe que representa um intervalo de datas [início, fim)<BR>
+ * O intervalo é vazio quando o fim não é maior que o início
+ */
+class DateRange {
+public:
+
+    /**
+     * Construtor padrão<BR>
+     * Cria um intervalo vazio
+     */
+    DateRange();
+
+    /**
+     * Construtor personalizado<BR>
+     * Cria o intervalo [start, end)
+     * \param start Início, em segundos desde 1900 (incluído)
+     * \param end Fim, em segundos desde 1900 (excluído)
+     */
+    DateRange(time_t start, time_t end);
+
+    /**
+     * Construtor personalizado<BR>
+     * Cria o intervalo [start, end)
+     * \param start Data de início (incluída)
+     * \param end Data de fim (excluída)
+     */
+    DateRange(Date& start, Date& end);
+
+    /**
+     * Retorna o início do intervalo
+     * \return Segundos desde 1900
+     */
+    time_t getStart() const;
+
+    /**
+     * Retorna o fim do intervalo (excluído)
+     * \return Segundos desde 1900
+     */
+    time_t getEnd() const;
+
+    /**
+     * Retorna a duração do intervalo
+     * \return Segundos (0 se vazio)
+     */
+    time_t getDuration() const;
+
+    /**
+     * Verifica se o intervalo é vazio
+     * \return true se for
+     */
+    bool isEmpty() const;
+
+    /**
+     * Verifica se uma data está no intervalo
+     * \return true se start <= seconds < end
+     * \param seconds Segundos desde 1900
+     */
+    bool contains(time_t seconds) const;
+
+    /**
+     * Verifica se dois intervalos têm alguma data em comum
+     * \return true se tiverem
+     * \param range Outro intervalo
+     */
+    bool overlaps(const DateRange& range) const;
+
+    /**
+     * Divide o intervalo nas viradas do calendário local (hora, dia, mês
+     * ou ano)<BR>
+     * Cada virada é o primeiro segundo em que o horário local alcança a
+     * nova hora, dia, mês ou ano; é calculada com aritmética de calendário
+     * e uma consulta ao fuso, sem addDateComponent
+     * \return false se a componente não for HOUR, MDAY, MONTH ou YEAR
+     * \param dateComponent Componente da virada (HOUR, MDAY, MONTH ou YEAR)
+     * \param parts Vetor onde as partes são acrescentadas, em ordem
+     */
+    bool split(DateComponent dateComponent, std::vector<DateRange>& parts) const;
+
+    /**
+     * Compara início e fim
+     * \return true se forem iguais
+     * \param range Outro intervalo
+     */
+    bool operator==(const DateRange& range) const;
+
+private:
+    /**
+     * Início (incluído), em segundos desde 1900
+     */
+    time_t start;
+
+    /**
+     * Fim (excluído), em segundos desde 1900
+     */
+    time_t end;
+};
+
+/**
+ * Classe que guarda intervalos ordenados, sem sobreposição e não vazios,
+ * em um vetor contíguo<BR>
+ * Intervalos que se tocam ([a, b) e [b, c)) são unidos em um só
+ */
+class DateRangeSet {
+public:
+
+    /**
+     * Construtor padrão<BR>
+     * Cria um conjunto vazio
+     */
+    DateRangeSet();
+
+    /**
+     * Construtor personalizado<BR>
+     * Cria o conjunto a partir de intervalos em qualquer ordem, com
+     * sobreposições e vazios (O(n log n))
+     * \param ranges Intervalos
+     */
+    DateRangeSet(const std::vector<DateRange>& ranges);
+
+    /**
+     * Acrescenta um intervalo, unindo-o aos que ele sobrepõe
+     * \param range Intervalo
+     */
+    void add(const DateRange& range);
+
+    /**
+     * Esvazia o conjunto
+     */
+    void clear();
+
+    /**
+     * Retorna a quantidade de intervalos
+     * \return Quantidade de intervalos
+     */
+    size_t size() const;
+
+    /**
+     * Verifica se o conjunto é vazio
+     * \return true se for
+     */
+    bool isEmpty() const;
+
+    /**
+     * Retorna um intervalo
+     * \return Intervalo na posição index (em ordem de início)
+     * \param index Posição (0 - size()-1)
+     */
+    const DateRange& getRange(size_t index) const;
+
+    /**
+     * Retorna todos os intervalos, em ordem
+     * \return Vetor de intervalos
+     */
+    const std::vector<DateRange>& getRanges() const;
+
+    /**
+     * Retorna a soma das durações dos intervalos
+     * \return Segundos
+     */
+    time_t getDuration() const;
+
+    /**
+     * Verifica se uma data está em algum intervalo (O(log n))
+     * \return true se estiver
+     * \param seconds Segundos desde 1900
+     */
+    bool contains(time_t seconds) const;
+
+    /**
+     * Verifica se um intervalo está inteiramente no conjunto (O(log n))
+     * \return true se estiver (intervalos vazios nunca estão)
+     * \param range Intervalo
+     */
+    bool contains(const DateRange& range) const;
+
+    /**
+     * Verifica se um intervalo tem alguma data no conjunto (O(log n))
+     * \return true se tiver
+     * \param range Intervalo
+     */
+    bool overlaps(const DateRange& range) const;
+
+    /**
+     * Calcula a união com outro conjunto (O(n + m))
+     * \param other Outro conjunto
+     * \param result Conjunto a ser preenchido (pode ser um dos operandos)
+     */
+    void getUnion(const DateRangeSet& other, DateRangeSet& result) const;
+
+    /**
+     * Calcula a interseção com outro conjunto (O(n + m))
+     * \param other Outro conjunto
+     * \param result Conjunto a ser preenchido (pode ser um dos operandos)
+     */
+    void getIntersection(const DateRangeSet& other, DateRangeSet& result) const;
+
+    /**
+     * Calcula a diferença (este conjunto menos o outro) (O(n + m))
+     * \param other Outro conjunto
+     * \param result Conjunto a ser preenchido (pode ser um dos operandos)
+     */
+    void getDifference(const DateRangeSet& other, DateRangeSet& result) const;
+
+private:
+    /**
+     * Posição do primeiro intervalo que termina depois de seconds
+     * \return Posição (size() se nenhum)
+     * \param seconds Segundos desde 1900
+     */
+    size_t findEndingAfter(time_t seconds) const;
+
+    /**
+     * Intervalos ordenados, sem sobreposição e não vazios
+     */
+    std::vector<DateRange> ranges;
+};
+
+} /** namespace dateCpp */
+
+#endif /* DATERANGE_HPP_ */
@@ -0,0 +1,278 @@
+/**
+ * \file timeofday.cpp
+ * Implementação do arquivo timeofday.h
+ */
+
+#include "timeofday.h"
+#include "datecommon.h"
+
+namespace dateCpp{
+
+/***************************************************************************
+ * Funções auxiliares
+ ***************************************************************************/
+
+/**
+ * Milissegundos em um dia
+ */
+#define MILLISECONDS_PER_DAY 86400000LL
+
+/**
+ * Calcula a hora local (milissegundos desde a meia-noite) de um instante
+ * \return Milissegundos desde a meia-noite
+ * \param seconds Segundos desde 1900
+ */
+int32_t getLocalTimeOfDay(time_t seconds){
+    long long local = getLocalSeconds(seconds);
+    return (int32_t) ((local - getFloorDivision(local, 86400) * 86400) * 1000);
+}
+
+/***************************************************************************
+ * Funções da classe TimeOfDay
+ ***************************************************************************/
+
+/**
+ * Construtor padrão<BR>
+ * Configura para a hora atual (horário local)
+ */
+TimeOfDay::TimeOfDay(){
+    setTime();
+}
+
+/**
+ * Construtor personalizado<BR>
+ * Configura para uma hora especificada (a hora atual se não for válida)
+ * \param hour Hora (0 - 23)
+ * \param minute Minutos (valor padrão 0)
+ * \param second Segundos (valor padrão 0)
+ * \param millisecond Milissegundos (valor padrão 0)
+ */
+TimeOfDay::TimeOfDay(int hour, int minute, int second, int millisecond){
+    // se a hora especificada não for válida...
+    if(!setTime(hour, minute, second, millisecond))
+        // configura para a hora atual
+        setTime();
+}
+
+/**
+ * Construtor personalizado<BR>
+ * Configura para a hora local de uma data
+ * \param date Data
+ */
+TimeOfDay::TimeOfDay(Date& date){
+    setTime(date);
+}
+
+/**
+ * Configura para a hora atual (horário local)
+ */
+void TimeOfDay::setTime(){
+    milliseconds = getLocalTimeOfDay(time(0));
+}
+
+/**
+ * Configura a hora
+ * \return false se não conseguir (a hora não é válida)
+ * \param hour Hora (0 - 23)
+ * \param minute Minutos (valor padrão 0)
+ * \param second Segundos (valor padrão 0)
+ * \param millisecond Milissegundos (valor padrão 0)
+ */
+bool TimeOfDay::setTime(int hour, int minute, int second, int millisecond){
+    if(!validateTime(hour, minute, second, millisecond))
+        return false;
+
+    milliseconds = ((hour * 60 + minute) * 60 + second) * 1000 + millisecond;
+    return true;
+}
+
+/**
+ * Configura para a hora local de uma data
+ * \param date Data
+ */
+void TimeOfDay::setTime(Date& date){
+    milliseconds = getLocalTimeOfDay(date.getDateInSeconds());
+}
+
+/**
+ * Configura a hora a partir dos milissegundos desde a meia-noite
+ * \return false se não conseguir (fora de 0 - 86399999)
+ * \param milliseconds Milissegundos desde a meia-noite
+ */
+bool TimeOfDay::setTimeInMilliseconds(int32_t milliseconds){
+    if(milliseconds < 0 || milliseconds >= MILLISECONDS_PER_DAY)
+        return false;
+
+    this->milliseconds = milliseconds;
+    return true;
+}
+
+/**
+ * Retorna os milissegundos desde a meia-noite
+ * \return Milissegundos desde a meia-noite (0 - 86399999)
+ */
+int32_t TimeOfDay::getTimeInMilliseconds() const{
+    return milliseconds;
+}
+
+/**
+ * Configura a hora de date para esta hora, mantendo o dia local de date
+ * \return false se não conseguir
+ * \param date Data a ser configurada
+ */
+bool TimeOfDay::getDate(Date& date) const{
+    // uma só decomposição, reentrante (Date::getDateComponent() usa localtime())
+    tm tm;
+    if(!getLocalTime(date.getDateInSeconds(), tm))
+        return false;
+
+    return date.setDate(tm.tm_mday, tm.tm_mon + 1, tm.tm_year + 1900, getDateComponent(HOUR),
+        getDateComponent(MINUTE), getDateComponent(SECOND));
+}
+
+/**
+ * Retorna um componente da hora (veja Date::getDateComponent())
+ * \return -1 se não conseguir retornar o solicitado (componentes de data)
+ * \param dateComponent HOUR, HOUR_AMPM, MINUTE ou SECOND
+ */
+int TimeOfDay::getDateComponent(DateComponent dateComponent) const{
+    int seconds = milliseconds / 1000;
+    int hour = seconds / 3600;
+
+    switch(dateComponent){
+    case HOUR:
+        return hour;
+    case HOUR_AMPM:
+        return (hour % 12 == 0 ? 12 : hour % 12);
+    case MINUTE:
+        return seconds / 60 % 60;
+    case SECOND:
+        return seconds % 60;
+    default:
+        return -1;
+    }
+}
+
+/**
+ * Retorna os milissegundos do segundo atual
+ * \return Milissegundos (0 - 999)
+ */
+int TimeOfDay::getMillisecond() const{
+    return milliseconds % 1000;
+}
+
+/**
+ * Gera uma string e coloca em dateString (veja Date::getStringDate())
+ * \param dateFormat DATE_HMS ou DATE_HMS_AMPM (outros formatos geram
+ *                   string vazia)
+ * \param dateString String a ser preenchida
+ */
+void TimeOfDay::getStringDate(DateFormat dateFormat, string& dateString) const{
+    if(dateFormat != DATE_HMS && dateFormat != DATE_HMS_AMPM){
+        dateString.clear();
+        return;
+    }
+
+    tm tm;
+    tm.tm_hour = getDateComponent(HOUR);
+    tm.tm_min = getDateComponent(MINUTE);
+    tm.tm_sec = getDateComponent(SECOND);
+
+    char buffer[DATE_MAX_LENGTH + 1];
+    dateString.assign(buffer, formatDate(tm, dateFormat, buffer, false));
+}
+
+/**
+ * Adiciona (ou subtrai) um valor em uma componente da hora<BR>
+ * O resultado dá a volta na meia-noite (23:30 + 1 hora = 0:30)
+ * \return false se não conseguir (componentes de data)
+ * \param dateComponent HOUR, HOUR_AMPM, MINUTE ou SECOND
+ * \param value Valor a ser adicionado (ou subtraído)
+ * \param add Se deverá adicionar ou subtrair (adiciona por padrão)
+ */
+bool TimeOfDay::addDateComponent(DateComponent dateComponent, int value, bool add){
+    long long unit;
+
+    switch(dateComponent){
+    case HOUR:
+    case HOUR_AMPM:
+        unit = 3600000;
+        break;
+    case MINUTE:
+        unit = 60000;
+        break;
+    case SECOND:
+        unit = 1000;
+        break;
+    default:
+        return false;
+    }
+
+    long long amount = (add ? (long long) value : -(long long) value) * unit;
+    long long result = (milliseconds + amount) % MILLISECONDS_PER_DAY;
+    if(result < 0) result += MILLISECONDS_PER_DAY;
+
+    milliseconds = (int32_t) result;
+    return true;
+}
+
+/**
+ * Imprime a hora no prompt
+ * \param dateFormat DATE_HMS ou DATE_HMS_AMPM
+ */
+void TimeOfDay::printDate(DateFormat dateFormat) const{
+    string dateString;
+    getStringDate(dateFormat, dateString);
+
+    cout<<dateString<<endl;
+}
+
+/**
+ * Verifica se uma hora é válida
+ * \return false se não for
+ * \param hour Hora (0 - 23)
+ * \param minute Minutos (valor padrão 0)
+ * \param second Segundos (valor padrão 0)
+ * \param millisecond Milissegundos (valor padrão 0)
+ */
+bool TimeOfDay::validateTime(int hour, int minute, int second, int millisecond) const{
+    if(millisecond<0 || millisecond>999)
+        return false;
+    else if(second<0 || second>59)
+        return false;
+    else if(minute<0 || minute>59)
+        return false;
+    else if(hour<0 || hour>23)
+        return false;
+
+    return true;
+}
+
+/**
+ * Compara duas horas
+ * \return true se forem iguais
+ * \param other Outra hora
+ */
+bool TimeOfDay::operator==(const TimeOfDay& other) const{
+    return milliseconds == other.milliseconds;
+}
+
+/**
+ * Compara duas horas
+ * \return true se forem diferentes
+ * \param other Outra hora
+ */
+bool TimeOfDay::operator!=(const TimeOfDay& other) const{
+    return milliseconds != other.milliseconds;
+}
+
+/**
+ * Compara duas horas
+ * \return true se esta vier antes de other
+ * \param other Outra hora
+ */
+bool TimeOfDay::operator<(const TimeOfDay& other) const{
+    return milliseconds < other.milliseconds;
+}
+
+} /** namespace dateCpp */
@@ -0,0 +1,165 @@
+/**
+ * \file timeofday.h
+ * Módulo que guarda apenas uma hora do dia em 32 bits
+ */
+
+#ifndef TIMEOFDAY_HPP_
+#define TIMEOFDAY_HPP_
+
+#include <string>
+#include <stdint.h>
+#include "date.h"
+
+namespace dateCpp{
+
+/**
+ * Classe que guarda uma hora do dia (milissegundos desde a meia-noite,
+ * 4 bytes, sem alocação)<BR>
+ * Não depende de fuso horário; só as conversões de/para Date usam o horário
+ * local
+ */
+class TimeOfDay {
+public:
+
+    /**
+     * Construtor padrão<BR>
+     * Configura para a hora atual (horário local)
+     */
+    TimeOfDay();
+
+    /**
+     * Construtor personalizado<BR>
+     * Configura para uma hora especificada (a hora atual se não for válida)
+     * \param hour Hora (0 - 23)
+     * \param minute Minutos (valor padrão 0)
+     * \param second Segundos (valor padrão 0)
+     * \param millisecond Milissegundos (valor padrão 0)
+     */
+    explicit TimeOfDay(int hour, int minute=0, int second=0, int millisecond=0);
+
+    /**
+     * Construtor personalizado<BR>
+     * Configura para a hora local de uma data
+     * \param date Data
+     */
+    explicit TimeOfDay(Date& date);
+
+    /**
+     * Configura para a hora atual (horário local)
+     */
+    void setTime();
+
+    /**
+     * Configura a hora
+     * \return false se não conseguir (a hora não é válida)
+     * \param hour Hora (0 - 23)
+     * \param minute Minutos (valor padrão 0)
+     * \param second Segundos (valor padrão 0)
+     * \param millisecond Milissegundos (valor padrão 0)
+     */
+    bool setTime(int hour, int minute=0, int second=0, int millisecond=0);
+
+    /**
+     * Configura para a hora local de uma data
+     * \param date Data
+     */
+    void setTime(Date& date);
+
+    /**
+     * Configura a hora a partir dos milissegundos desde a meia-noite
+     * \return false se não conseguir (fora de 0 - 86399999)
+     * \param milliseconds Milissegundos desde a meia-noite
+     */
+    bool setTimeInMilliseconds(int32_t milliseconds);
+
+    /**
+     * Retorna os milissegundos desde a meia-noite
+     * \return Milissegundos desde a meia-noite (0 - 86399999)
+     */
+    int32_t getTimeInMilliseconds() const;
+
+    /**
+     * Configura a hora de date para esta hora, mantendo o dia local de date
+     * \return false se não conseguir
+     * \param date Data a ser configurada
+     */
+    bool getDate(Date& date) const;
+
+    /**
+     * Retorna um componente da hora (veja Date::getDateComponent())
+     * \return -1 se não conseguir retornar o solicitado (componentes de data)
+     * \param dateComponent HOUR, HOUR_AMPM, MINUTE ou SECOND
+     */
+    int getDateComponent(DateComponent dateComponent) const;
+
+    /**
+     * Retorna os milissegundos do segundo atual
+     * \return Milissegundos (0 - 999)
+     */
+    int getMillisecond() const;
+
+    /**
+     * Gera uma string e coloca em dateString (veja Date::getStringDate())
+     * \param dateFormat DATE_HMS ou DATE_HMS_AMPM (outros formatos geram
+     *                   string vazia)
+     * \param dateString String a ser preenchida
+     */
+    void getStringDate(DateFormat dateFormat, string& dateString) const;
+
+    /**
+     * Adiciona (ou subtrai) um valor em uma componente da hora<BR>
+     * O resultado dá a volta na meia-noite (23:30 + 1 hora = 0:30)
+     * \return false se não conseguir (componentes de data)
+     * \param dateComponent HOUR, HOUR_AMPM, MINUTE ou SECOND
+     * \param value Valor a ser adicionado (ou subtraído)
+     * \param add Se deverá adicionar ou subtrair (adiciona por padrão)
+     */
+    bool addDateComponent(DateComponent dateComponent, int value, bool add=true);
+
+    /**
+     * Imprime a hora no prompt
+     * \param dateFormat DATE_HMS ou DATE_HMS_AMPM
+     */
+    void printDate(DateFormat dateFormat) const;
+
+    /**
+     * Verifica se uma hora é válida
+     * \return false se não for
+     * \param hour Hora (0 - 23)
+     * \param minute Minutos (valor padrão 0)
+     * \param second Segundos (valor padrão 0)
+     * \param millisecond Milissegundos (valor padrão 0)
+     */
+    bool validateTime(int hour, int minute=0, int second=0, int millisecond=0) const;
+
+    /**
+     * Compara duas horas
+     * \return true se forem iguais
+     * \param other Outra hora
+     */
+    bool operator==(const TimeOfDay& other) const;
+
+    /**
+     * Compara duas horas
+     * \return true se forem diferentes
+     * \param other Outra hora
+     */
+    bool operator!=(const TimeOfDay& other) const;
+
+    /**
+     * Compara duas horas
+     * \return true se esta vier antes de other
+     * \param other Outra hora
+     */
+    bool operator<(const TimeOfDay& other) const;
+
+private:
+    /**
+     * Milissegundos desde a meia-noite
+     */
+    int32_t milliseconds;
+};
+
+} /** namespace dateCpp */
+
+#endif /* TIMEOFDAY_HPP_ */
@@ -0,0 +1,491 @@
+/**
+ * \file timerwheel.cpp
+ * Implementação do arquivo timerwheel.h
+ */
+
+#include "timerwheel.h"
+#include <algorithm>
+
+namespace dateCpp{
+
+/***************************************************************************
+ * Constantes
+ ***************************************************************************/
+
+/**
+ * Bits de tempo cobertos por cada nível da roda
+ */
+#define WHEEL_LEVEL_BITS 6
+/**
+ * Slots por nível (um mapa de ocupação de 64 bits por nível)
+ */
+#define WHEEL_SLOTS (1 << WHEEL_LEVEL_BITS)
+/**
+ * Quantidade de níveis (cobrem 2^30 segundos, cerca de 34 anos)
+ */
+#define WHEEL_LEVELS 5
+/**
+ * Lista dos temporizadores além do último nível
+ */
+#define WHEEL_OVERFLOW_LIST (WHEEL_LEVELS * WHEEL_SLOTS)
+/**
+ * Lista dos temporizadores agendados para datas que já passaram
+ */
+#define WHEEL_EXPIRED_LIST (WHEEL_OVERFLOW_LIST + 1)
+/**
+ * Marca dos nós coletados que aguardam o despacho (não é uma lista)
+ */
+#define WHEEL_DISPATCHING (WHEEL_EXPIRED_LIST + 1)
+/**
+ * Índice nulo (fim de lista / nó livre)
+ */
+#define WHEEL_NIL 0xFFFFFFFFu
+
+/***************************************************************************
+ * Funções auxiliares
+ ***************************************************************************/
+
+/**
+ * Retorna a posição do bit menos significativo ligado
+ * \return Posição do bit (0 - 63)
+ * \param value Valor diferente de zero
+ */
+int getLowestSetBit(uint64_t value){
+#if defined(__GNUC__)
+    return __builtin_ctzll(value);
+#else
+    int position = 0;
+    while(!(value & 1)){
+        value >>= 1;
+        position++;
+    }
+    return position;
+#endif
+}
+
+/***************************************************************************
+ * Funções da classe TimerWheel
+ ***************************************************************************/
+
+/**
+ * Construtor padrão<BR>
+ * Configura o relógio da roda para a data atual
+ */
+TimerWheel::TimerWheel(){
+    // Date é construída com a data atual
+    Date date;
+    init(date.getDateInSeconds());
+}
+
+/**
+ * Construtor personalizado<BR>
+ * Configura o relógio da roda para uma data especificada
+ * \param seconds Segundos desde 1900
+ */
+TimerWheel::TimerWheel(time_t seconds){
+    init(seconds);
+}
+
+/**
+ * Inicializa as listas vazias
+ * \param seconds Relógio inicial, em segundos desde 1900
+ */
+void TimerWheel::init(time_t seconds){
+    now = seconds;
+    heads.assign(WHEEL_EXPIRED_LIST + 1, WHEEL_NIL);
+    occupied.assign(WHEEL_LEVELS, 0);
+    freeHead = WHEEL_NIL;
+    count = 0;
+}
+
+/**
+ * Agenda um callback para uma data
+ * \return Identificador do temporizador
+ * \param date Data em que o callback deve ser chamado
+ * \param callback Função a ser chamada
+ * \param userData Ponteiro repassado ao callback (padrão NULL)
+ */
+TimerId TimerWheel::schedule(Date& date, TimerCallback callback, void* userData){
+    return schedule(date.getDateInSeconds(), callback, userData);
+}
+
+/**
+ * Agenda um callback para uma data em segundos<BR>
+ * Datas que já passaram são despachadas no próximo advance()
+ * \return Identificador do temporizador
+ * \param seconds Segundos desde 1900
+ * \param callback Função a ser chamada
+ * \param userData Ponteiro repassado ao callback (padrão NULL)
+ */
+TimerId TimerWheel::schedule(time_t seconds, TimerCallback callback, void* userData){
+    uint32_t index;
+
+    // reutiliza um nó livre, se houver
+    if(freeHead != WHEEL_NIL){
+        index = freeHead;
+        freeHead = nodes[index].next;
+    }
+    // caso contrário, cresce a reserva
+    else{
+        index = (uint32_t) nodes.size();
+        TimerNode node;
+        node.generation = 1;
+        nodes.push_back(node);
+    }
+
+    TimerNode& node = nodes[index];
+    node.expires = seconds;
+    node.callback = callback;
+    node.userData = userData;
+
+    // o segundo atual já foi processado: vai para a lista de vencidos
+    if(seconds <= now){
+        node.list = WHEEL_EXPIRED_LIST;
+        node.prev = WHEEL_NIL;
+        node.next = heads[WHEEL_EXPIRED_LIST];
+        if(node.next != WHEEL_NIL)
+            nodes[node.next].prev = index;
+        heads[WHEEL_EXPIRED_LIST] = index;
+    }
+    else
+        link(index);
+
+    count++;
+
+    return ((TimerId) node.generation << 32) | index;
+}
+
+/**
+ * Cancela um temporizador<BR>
+ * Dentro do próprio callback o temporizador ainda existe: cancelá-lo
+ * retorna true e não tem outro efeito
+ * \return false se o temporizador não existe (já expirou ou foi cancelado)
+ * \param id Identificador retornado por schedule()
+ */
+bool TimerWheel::cancel(TimerId id){
+    uint32_t index = (uint32_t) id;
+    uint32_t generation = (uint32_t) (id >> 32);
+
+    // id inválido, nó livre ou já reutilizado
+    if(index >= nodes.size() || nodes[index].generation != generation
+        || nodes[index].list == WHEEL_NIL)
+        return false;
+
+    // nós no lote de vencidos não estão em nenhuma lista; dispatch() percebe
+    // pela geração que o temporizador foi cancelado
+    if(nodes[index].list != WHEEL_DISPATCHING)
+        unlink(index);
+    release(index);
+
+    return true;
+}
+
+/**
+ * Avança o relógio da roda até a data atual (veja Date::setDate())
+ * \return Quantidade de callbacks chamados
+ */
+size_t TimerWheel::advance(){
+    Date date;
+    date.setDate();
+    return advance(date.getDateInSeconds());
+}
+
+/**
+ * Avança o relógio da roda até uma data
+ * \return Quantidade de callbacks chamados
+ * \param date Data destino
+ */
+size_t TimerWheel::advance(Date& date){
+    return advance(date.getDateInSeconds());
+}
+
+/**
+ * Avança o relógio da roda até uma data em segundos<BR>
+ * Datas anteriores ao relógio atual apenas despacham os pendentes
+ * \return Quantidade de callbacks chamados
+ * \param seconds Segundos desde 1900
+ */
+size_t TimerWheel::advance(time_t seconds){
+
+    // primeiro os que foram agendados para datas que já passaram
+    size_t fired = dispatchExpired();
+
+    while(seconds > now){
+        // pula direto para o próximo slot ocupado
+        time_t next = nextEvent();
+
+        // nada vence até a data destino
+        if(next == -1 || next > seconds){
+            now = seconds;
+            break;
+        }
+
+        step(next);
+        fired += dispatch();
+
+        // callbacks podem ter agendado para o segundo atual (ou antes):
+        // vencem antes do próximo slot
+        fired += dispatchExpired();
+    }
+
+    return fired;
+}
+
+/**
+ * Retorna o relógio da roda
+ * \return Segundos desde 1900
+ */
+time_t TimerWheel::getCurrentTime(){
+    return now;
+}
+
+/**
+ * Retorna a quantidade de temporizadores pendentes
+ * \return Temporizadores pendentes
+ */
+size_t TimerWheel::size(){
+    return count;
+}
+
+/**
+ * Reserva memória para uma quantidade de temporizadores
+ * \param count Quantidade de temporizadores
+ */
+void TimerWheel::reserve(size_t count){
+    nodes.reserve(count);
+}
+
+/**
+ * Coloca um nó no slot correspondente à sua data, relativa ao relógio<BR>
+ * O nível é o do grupo de bits mais alto em que a data e o relógio diferem,
+ * logo o slot escolhido sempre está à frente da posição atual do nível
+ * \param index Índice do nó (a data deve ser >= relógio)
+ */
+void TimerWheel::link(uint32_t index){
+    TimerNode& node = nodes[index];
+    uint64_t expires = (uint64_t) node.expires;
+    uint64_t diff = expires ^ (uint64_t) now;
+
+    // procura o nível
+    uint32_t list = WHEEL_OVERFLOW_LIST;
+    for(int level = 0; level < WHEEL_LEVELS; level++){
+        int shift = level * WHEEL_LEVEL_BITS;
+        if((diff >> shift) < WHEEL_SLOTS){
+            uint32_t slot = (uint32_t) ((expires >> shift) & (WHEEL_SLOTS - 1));
+            list = level * WHEEL_SLOTS + slot;
+            occupied[level] |= ((uint64_t) 1 << slot);
+            break;
+        }
+    }
+
+    // insere no início da lista
+    node.list = list;
+    node.prev = WHEEL_NIL;
+    node.next = heads[list];
+    if(node.next != WHEEL_NIL)
+        nodes[node.next].prev = index;
+    heads[list] = index;
+}
+
+/**
+ * Retira um nó da sua lista
+ * \param index Índice do nó
+ */
+void TimerWheel::unlink(uint32_t index){
+    TimerNode& node = nodes[index];
+
+    if(node.prev != WHEEL_NIL)
+        nodes[node.prev].next = node.next;
+    else
+        heads[node.list] = node.next;
+
+    if(node.next != WHEEL_NIL)
+        nodes[node.next].prev = node.prev;
+
+    // slot de nível que ficou vazio
+    if(node.list < WHEEL_OVERFLOW_LIST && heads[node.list] == WHEEL_NIL)
+        occupied[node.list / WHEEL_SLOTS] &= ~((uint64_t) 1 << (node.list % WHEEL_SLOTS));
+}
+
+/**
+ * Redistribui os nós de uma lista entre os níveis inferiores
+ * \param list Lista a ser redistribuída
+ */
+void TimerWheel::cascade(uint32_t list){
+    uint32_t index = heads[list];
+
+    // esvazia a lista
+    heads[list] = WHEEL_NIL;
+    if(list < WHEEL_OVERFLOW_LIST)
+        occupied[list / WHEEL_SLOTS] &= ~((uint64_t) 1 << (list % WHEEL_SLOTS));
+
+    while(index != WHEEL_NIL){
+        uint32_t next = nodes[index].next;
+        link(index);
+        index = next;
+    }
+}
+
+/**
+ * Move os nós de uma lista para o lote de vencidos<BR>
+ * Os nós só são liberados no despacho, para que cancel() continue
+ * valendo até lá
+ * \param list Lista a ser coletada
+ */
+void TimerWheel::collect(uint32_t list){
+    uint32_t index = heads[list];
+
+    // esvazia a lista
+    heads[list] = WHEEL_NIL;
+    if(list < WHEEL_OVERFLOW_LIST)
+        occupied[list / WHEEL_SLOTS] &= ~((uint64_t) 1 << (list % WHEEL_SLOTS));
+
+    while(index != WHEEL_NIL){
+        TimerNode& node = nodes[index];
+        uint32_t next = node.next;
+
+        DueTimer dueTimer;
+        dueTimer.expires = node.expires;
+        dueTimer.index = index;
+        dueTimer.generation = node.generation;
+        due.push_back(dueTimer);
+        node.list = WHEEL_DISPATCHING;
+
+        index = next;
+    }
+}
+
+/**
+ * Devolve um nó para a lista de livres (ids antigos deixam de valer)
+ * \param index Índice do nó
+ */
+void TimerWheel::release(uint32_t index){
+    TimerNode& node = nodes[index];
+
+    node.list = WHEEL_NIL;
+    node.generation = (node.generation == 0xFFFFFFFFu ? 1 : node.generation + 1);
+    node.next = freeHead;
+    freeHead = index;
+    count--;
+}
+
+/**
+ * Compara dois temporizadores vencidos pela data
+ * \return true se a vier antes de b
+ * \param a Temporizador vencido
+ * \param b Temporizador vencido
+ */
+bool TimerWheel::isDueBefore(const DueTimer& a, const DueTimer& b){
+    return a.expires < b.expires;
+}
+
+/**
+ * Chama os callbacks do lote de vencidos, pulando os que foram cancelados
+ * por callbacks anteriores do mesmo lote
+ * \return Quantidade de callbacks chamados
+ */
+size_t TimerWheel::dispatch(){
+    size_t fired = 0;
+
+    // novos temporizadores agendados pelos callbacks não entram neste lote
+    for(size_t i = 0; i < due.size(); i++){
+        uint32_t index = due[i].index;
+        if(nodes[index].generation != due[i].generation)
+            continue;
+
+        // copia antes: o callback pode fazer a reserva de nós crescer
+        TimerCallback callback = nodes[index].callback;
+        void* userData = nodes[index].userData;
+        callback(due[i].expires, userData);
+        fired++;
+
+        // o próprio callback pode ter cancelado (e até reaproveitado) o nó
+        if(nodes[index].generation == due[i].generation)
+            release(index);
+    }
+
+    due.clear();
+
+    return fired;
+}
+
+/**
+ * Despacha a lista de vencidos, em ordem de data, até ela ficar vazia
+ * (os callbacks podem agendar novos temporizadores já vencidos)
+ * \return Quantidade de callbacks chamados
+ */
+size_t TimerWheel::dispatchExpired(){
+    size_t fired = 0;
+
+    while(heads[WHEEL_EXPIRED_LIST] != WHEEL_NIL){
+        // a lista guarda o último agendado na frente: inverte antes de ordenar
+        collect(WHEEL_EXPIRED_LIST);
+        std::reverse(due.begin(), due.end());
+        std::stable_sort(due.begin(), due.end(), isDueBefore);
+        fired += dispatch();
+    }
+
+    return fired;
+}
+
+/**
+ * Processa um segundo: redistribui os níveis que viraram e coleta
+ * o slot do nível 0
+ * \param seconds Segundo a ser processado
+ */
+void TimerWheel::step(time_t seconds){
+    uint64_t time = (uint64_t) seconds;
+    now = seconds;
+
+    // o estouro é revisto a cada volta do último nível
+    const int topBits = WHEEL_LEVELS * WHEEL_LEVEL_BITS;
+    if((time & (((uint64_t) 1 << topBits) - 1)) == 0)
+        cascade(WHEEL_OVERFLOW_LIST);
+
+    // do nível mais alto para o mais baixo
+    for(int level = WHEEL_LEVELS - 1; level > 0; level--){
+        int shift = level * WHEEL_LEVEL_BITS;
+        if((time & (((uint64_t) 1 << shift) - 1)) == 0)
+            cascade(level * WHEEL_SLOTS + (uint32_t) ((time >> shift) & (WHEEL_SLOTS - 1)));
+    }
+
+    collect((uint32_t) (time & (WHEEL_SLOTS - 1)));
+}
+
+/**
+ * Retorna o próximo segundo em que algum slot ocupado precisa ser processado
+ * \return Segundos desde 1900, ou -1 se a roda estiver vazia
+ */
+time_t TimerWheel::nextEvent(){
+    uint64_t time = (uint64_t) now;
+    uint64_t best = 0;
+    bool found = false;
+
+    for(int level = 0; level < WHEEL_LEVELS; level++){
+        if(!occupied[level]) continue;
+
+        // o menor slot ocupado de cada nível está à frente da posição atual
+        int shift = level * WHEEL_LEVEL_BITS;
+        uint64_t base = (time >> (shift + WHEEL_LEVEL_BITS)) << (shift + WHEEL_LEVEL_BITS);
+        uint64_t event = base | ((uint64_t) getLowestSetBit(occupied[level]) << shift);
+
+        if(!found || event < best){
+            best = event;
+            found = true;
+        }
+    }
+
+    // o estouro só é revisto na próxima volta do último nível
+    if(heads[WHEEL_OVERFLOW_LIST] != WHEEL_NIL){
+        const int topBits = WHEEL_LEVELS * WHEEL_LEVEL_BITS;
+        uint64_t event = ((time >> topBits) + 1) << topBits;
+        if(!found || event < best){
+            best = event;
+            found = true;
+        }
+    }
+
+    return found ? (time_t) best : -1;
+}
+
+} /** namespace dateCpp */
@@ -0,0 +1,211 @@
+/**
+ * \file timerwheel.h
+ * Módulo que agenda callbacks para datas específicas usando uma
+ * roda de temporizadores hierárquica (timer wheel)
+ */
+
+#ifndef TIMERWHEEL_HPP_
+#define TIMERWHEEL_HPP_
+
+#include <ctime>
+#include <cstddef>
+#include <vector>
+#include <stdint.h>
+#include "date.h"
+
+namespace dateCpp{
+
+/**
+ * Callback chamado quando um temporizador expira
+ * \param seconds Data agendada do temporizador, em segundos desde 1900
+ * \param userData Ponteiro fornecido no agendamento
+ */
+typedef void (*TimerCallback)(time_t seconds, void* userData);
+
+/**
+ * Identificador de um temporizador agendado (0 nunca é um id válido)
+ */
+typedef uint64_t TimerId;
+
+/**
+ * Classe que agenda callbacks para datas (resolução de 1 segundo)<BR>
+ * Inserção e cancelamento são O(1); o avanço do relógio pula slots vazios
+ * e despacha os callbacks vencidos em lotes, em ordem de data (inclusive
+ * os agendados para datas que já passaram).<BR>
+ * Obs: os callbacks podem agendar ou cancelar temporizadores, inclusive
+ * outros do mesmo lote (que então não são chamados), mas não podem chamar
+ * advance() na mesma roda. Temporizadores agendados por um callback para o
+ * segundo atual (ou antes) vencem no mesmo advance(), antes dos seguintes;
+ * um callback que sempre se reagenda assim impede advance() de terminar.
+ */
+class TimerWheel {
+public:
+
+    /**
+     * Construtor padrão<BR>
+     * Configura o relógio da roda para a data atual
+     */
+    TimerWheel();
+
+    /**
+     * Construtor personalizado<BR>
+     * Configura o relógio da roda para uma data especificada
+     * \param seconds Segundos desde 1900
+     */
+    TimerWheel(time_t seconds);
+
+    /**
+     * Agenda um callback para uma data
+     * \return Identificador do temporizador
+     * \param date Data em que o callback deve ser chamado
+     * \param callback Função a ser chamada
+     * \param userData Ponteiro repassado ao callback (padrão NULL)
+     */
+    TimerId schedule(Date& date, TimerCallback callback, void* userData=NULL);
+
+    /**
+     * Agenda um callback para uma data em segundos<BR>
+     * Datas que já passaram são despachadas no próximo advance()
+     * \return Identificador do temporizador
+     * \param seconds Segundos desde 1900
+     * \param callback Função a ser chamada
+     * \param userData Ponteiro repassado ao callback (padrão NULL)
+     */
+    TimerId schedule(time_t seconds, TimerCallback callback, void* userData=NULL);
+
+    /**
+     * Cancela um temporizador<BR>
+     * Dentro do próprio callback o temporizador ainda existe: cancelá-lo
+     * retorna true e não tem outro efeito
+     * \return false se o temporizador não existe (já expirou ou foi cancelado)
+     * \param id Identificador retornado por schedule()
+     */
+    bool cancel(TimerId id);
+
+    /**
+     * Avança o relógio da roda até a data atual (veja Date::setDate())
+     * \return Quantidade de callbacks chamados
+     */
+    size_t advance();
+
+    /**
+     * Avança o relógio da roda até uma data
+     * \return Quantidade de callbacks chamados
+     * \param date Data destino
+     */
+    size_t advance(Date& date);
+
+    /**
+     * Avança o relógio da roda até uma data em segundos<BR>
+     * Datas anteriores ao relógio atual apenas despacham os pendentes
+     * \return Quantidade de callbacks chamados
+     * \param seconds Segundos desde 1900
+     */
+    size_t advance(time_t seconds);
+
+    /**
+     * Retorna o relógio da roda
+     * \return Segundos desde 1900
+     */
+    time_t getCurrentTime();
+
+    /**
+     * Retorna a quantidade de temporizadores pendentes
+     * \return Temporizadores pendentes
+     */
+    size_t size();
+
+    /**
+     * Reserva memória para uma quantidade de temporizadores
+     * \param count Quantidade de temporizadores
+     */
+    void reserve(size_t count);
+
+private:
+    /**
+     * Nó de um temporizador (listas duplamente encadeadas por índice)
+     */
+    struct TimerNode{
+        // data agendada em segundos desde 1900
+        time_t expires;
+        TimerCallback callback;
+        void* userData;
+        // vizinhos na lista (ou próximo livre, em next)
+        uint32_t prev;
+        uint32_t next;
+        // lista em que o nó está (0xFFFFFFFF se livre, WHEEL_DISPATCHING
+        // se está no lote de vencidos)
+        uint32_t list;
+        // incrementado a cada reuso, invalida ids antigos
+        uint32_t generation;
+    };
+
+    /**
+     * Temporizador vencido, aguardando o despacho (o nó continua reservado
+     * até o callback ser chamado)
+     */
+    struct DueTimer{
+        time_t expires;
+        uint32_t index;
+        // geração do nó na coleta; se mudar, o temporizador foi cancelado
+        uint32_t generation;
+    };
+
+    /**
+     * Compara dois temporizadores vencidos pela data
+     * \return true se a vier antes de b
+     * \param a Temporizador vencido
+     * \param b Temporizador vencido
+     */
+    static bool isDueBefore(const DueTimer& a, const DueTimer& b);
+
+    void init(time_t seconds);
+    void link(uint32_t index);
+    void unlink(uint32_t index);
+    void cascade(uint32_t list);
+    void collect(uint32_t list);
+    void release(uint32_t index);
+    size_t dispatch();
+    size_t dispatchExpired();
+    void step(time_t seconds);
+    time_t nextEvent();
+
+    /**
+     * Relógio da roda (último segundo processado)
+     */
+    time_t now;
+
+    /**
+     * Reserva de nós; os livres ficam encadeados em freeHead
+     */
+    std::vector<TimerNode> nodes;
+
+    /**
+     * Cabeças das listas: slots de cada nível, estouro e vencidos
+     */
+    std::vector<uint32_t> heads;
+
+    /**
+     * Mapa de ocupação dos slots de cada nível
+     */
+    std::vector<uint64_t> occupied;
+
+    /**
+     * Lote de temporizadores vencidos (reutilizado entre avanços)
+     */
+    std::vector<DueTimer> due;
+
+    /**
+     * Primeiro nó livre
+     */
+    uint32_t freeHead;
+
+    /**
+     * Temporizadores pendentes
+     */
+    size_t count;
+};
+
+} /** namespace dateCpp */
+
+#endif /* TIMERWHEEL_HPP_ */
@@ -1,11 +1,1548 @@
 /*
  * main.cpp
  *
+ * Compara as operações de dateCpp::Date com uma referência baseada na libc
+ * (localtime/mktime/timegm) em vários fusos horários e mede o tempo de
+ * cada operação.
+ *
+ * Uso: main [opções]
+ *   --random N          timestamps aleatórios por fuso (padrão 100000)
+ *   --timers N          temporizadores no benchmark da roda (padrão 10000000)
+ *   --baseline ARQ      falha se alguma operação ficar mais lenta que em ARQ
+ *   --margin P          margem tolerada sobre o baseline, em % (padrão 20)
+ *   --save-baseline ARQ grava os tempos medidos em ARQ
+ *   --repeat N          repetições de cada medição; vale a melhor (padrão 5)
+ *
+ * Retorna 0 se não houver divergências nem regressões.
  */
 
-int main(int argc, char **argv) {
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "../src/date.h"
+#include "../src/timerwheel.h"
+#include "../src/daterange.h"
+#include "../src/datecolumn.h"
+#include "../src/dateonly.h"
+#include "../src/timeofday.h"
+#include "../src/dateformatter.h"
+
+using namespace dateCpp;
+using std::map;
+using std::vector;
+
+/***************************************************************************
+ * Registro de divergências e tempos
+ ***************************************************************************/
+
+/*
+ * Quantidade de divergências impressas por operação
+ */
+#define MAX_REPORTED 5
+
+struct DiffStats{
+    size_t checks;
+    size_t failures;
+};
+
+map<string, DiffStats> diffStats;
+const char* currentZone = "";
+
+/*
+ * Registra uma comparação; imprime as primeiras divergências de cada operação
+ */
+bool expect(bool ok, const char* path, time_t seconds, const string& detail){
+    DiffStats& stats = diffStats[path];
+    stats.checks++;
+    if(!ok){
+        if(stats.failures < MAX_REPORTED)
+            printf("  MISMATCH %s TZ=%s t=%lld: %s\n", path, currentZone,
+                (long long) seconds, detail.c_str());
+        stats.failures++;
+    }
+    return ok;
+}
+
+string format(const char* pattern, ...){
+    char buffer[256];
+    va_list args;
+    va_start(args, pattern);
+    vsnprintf(buffer, sizeof buffer, pattern, args);
+    va_end(args);
+    return buffer;
+}
+
+/*
+ * Tempos medidos, em ns por operação (o melhor entre as repetições), e a
+ * ordem em que foram medidos
+ */
+map<string, double> perfResults;
+vector<string> perfOrder;
+
+double nsPerOp(clock_t start, clock_t end, size_t ops){
+    if(ops == 0) return 0;
+    return (double) (end - start) * 1e9 / CLOCKS_PER_SEC / ops;
+}
+
+/*
+ * Tempo real (monotônico), em segundos
+ */
+double getWallSeconds(){
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+double nsPerOpWall(double start, double end, size_t ops){
+    if(ops == 0) return 0;
+    return (end - start) * 1e9 / ops;
+}
 
-	return 0;
+/*
+ * Guarda o tempo de uma repetição; fica o menor, menos sujeito a ruído
+ */
+void recordPerf(const string& path, double ns){
+    map<string, double>::iterator it = perfResults.find(path);
+    if(it == perfResults.end()){
+        perfResults[path] = ns;
+        perfOrder.push_back(path);
+    }
+    else if(ns < it->second)
+        it->second = ns;
 }
 
+void printPerf(){
+    for(size_t i = 0; i < perfOrder.size(); i++)
+        printf("  %-28s %10.1f ns/op\n", perfOrder[i].c_str(), perfResults[perfOrder[i]]);
+}
+
+/*
+ * Evita que o compilador descarte os laços medidos
+ */
+volatile long long perfSink;
+
+/*
+ * Gerador determinístico (xorshift64*)
+ */
+uint64_t randomState = 88172645463325252ULL;
+
+uint64_t nextRandom(){
+    randomState ^= randomState >> 12;
+    randomState ^= randomState << 25;
+    randomState ^= randomState >> 27;
+    return randomState * 2685821657736338717ULL;
+}
+
+/***************************************************************************
+ * Referência baseada na libc
+ ***************************************************************************/
+
+const DateComponent allComponents[] = {
+    MDAY, YDAY, WDAY, MONTH, YEAR, HOUR, HOUR_AMPM, MINUTE, SECOND
+};
+const char* componentNames[] = {
+    "MDAY", "YDAY", "WDAY", "MONTH", "YEAR", "HOUR", "HOUR_AMPM", "MINUTE", "SECOND"
+};
+const DateFormat allFormats[] = {
+    DATE_DMY, DATE_YMD, DATE_HMS, DATE_HMS_AMPM,
+    DATE_DMY_HMS, DATE_YMD_HMS, DATE_DMY_HMS_AMPM, DATE_YMD_HMS_AMPM
+};
+const char* weekNames[] = {
+    "Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"
+};
+
+int refComponent(time_t seconds, DateComponent dateComponent){
+    tm t;
+    localtime_r(&seconds, &t);
+
+    switch(dateComponent){
+    case MDAY: return t.tm_mday;
+    case YDAY: return t.tm_yday;
+    case WDAY: return t.tm_wday;
+    case MONTH: return t.tm_mon + 1;
+    case YEAR: return t.tm_year + 1900;
+    case HOUR: return t.tm_hour;
+    case HOUR_AMPM: return t.tm_hour % 12 == 0 ? 12 : t.tm_hour % 12;
+    case MINUTE: return t.tm_min;
+    case SECOND: return t.tm_sec;
+    }
+    return -1;
+}
+
+const DateFormat isoFormats[] = {DATE_ISO8601_BASIC, DATE_ISO8601, DATE_RFC3339};
+const char* isoNames[] = {"ISO8601_BASIC", "ISO8601", "RFC3339"};
+
+/*
+ * ISO 8601 / RFC 3339 via strftime; fusos com segundos são escritos em UTC
+ */
+string refIso(time_t seconds, int milliseconds, DateFormat dateFormat){
+    tm t;
+    localtime_r(&seconds, &t);
+    long offset = t.tm_gmtoff;
+    bool zulu = (offset % 60 != 0);
+    if(zulu){
+        gmtime_r(&seconds, &t);
+        offset = 0;
+    }
+
+    bool extended = (dateFormat != DATE_ISO8601_BASIC);
+    char buffer[64];
+    strftime(buffer, sizeof buffer, extended ? "%Y-%m-%dT%H:%M:%S" : "%Y%m%dT%H%M%S", &t);
+
+    string result = buffer;
+    if(dateFormat == DATE_RFC3339)
+        result += format(".%03d", milliseconds);
+    if(zulu)
+        result += "Z";
+    else{
+        long absolute = offset < 0 ? -offset : offset;
+        result += format(extended ? "%c%02ld:%02ld" : "%c%02ld%02ld",
+            offset < 0 ? '-' : '+', absolute / 3600, absolute / 60 % 60);
+    }
+    return result;
+}
+
+string refString(time_t seconds, DateFormat dateFormat, bool showWeek){
+    tm t;
+    localtime_r(&seconds, &t);
+
+    int day = t.tm_mday, month = t.tm_mon + 1, year = t.tm_year + 1900;
+    int hour12 = t.tm_hour % 12 == 0 ? 12 : t.tm_hour % 12;
+    const char* ampm = t.tm_hour < 12 ? "am" : "pm";
+    char buffer[96];
+
+    switch(dateFormat){
+    case DATE_DMY:
+        snprintf(buffer, sizeof buffer, "%d/%d/%d", day, month, year);
+        break;
+    case DATE_YMD:
+        snprintf(buffer, sizeof buffer, "%d/%d/%d", year, month, day);
+        break;
+    case DATE_HMS:
+        snprintf(buffer, sizeof buffer, "%d:%d:%d", t.tm_hour, t.tm_min, t.tm_sec);
+        break;
+    case DATE_HMS_AMPM:
+        snprintf(buffer, sizeof buffer, "%d:%d:%d %s", hour12, t.tm_min, t.tm_sec, ampm);
+        break;
+    case DATE_DMY_HMS:
+        snprintf(buffer, sizeof buffer, "%d/%d/%d %d:%d:%d",
+            day, month, year, t.tm_hour, t.tm_min, t.tm_sec);
+        break;
+    case DATE_YMD_HMS:
+        snprintf(buffer, sizeof buffer, "%d/%d/%d %d:%d:%d",
+            year, month, day, t.tm_hour, t.tm_min, t.tm_sec);
+        break;
+    case DATE_DMY_HMS_AMPM:
+        snprintf(buffer, sizeof buffer, "%d/%d/%d %d:%d:%d %s",
+            day, month, year, hour12, t.tm_min, t.tm_sec, ampm);
+        break;
+    case DATE_YMD_HMS_AMPM:
+        snprintf(buffer, sizeof buffer, "%d/%d/%d %d:%d:%d %s",
+            year, month, day, hour12, t.tm_min, t.tm_sec, ampm);
+        break;
+    default:
+        return refIso(seconds, 0, dateFormat);
+    }
+
+    string result = buffer;
+    if(showWeek){
+        result += " ";
+        result += weekNames[t.tm_wday];
+    }
+    return result;
+}
+
+bool refAdd(time_t seconds, DateComponent dateComponent, int value, time_t& result){
+    tm t;
+    localtime_r(&seconds, &t);
+
+    switch(dateComponent){
+    case MDAY: t.tm_mday += value; break;
+    case YDAY: t.tm_yday += value; break;
+    case WDAY: t.tm_wday += value; break;
+    case MONTH: t.tm_mon += value; break;
+    case YEAR: t.tm_year += value; break;
+    case HOUR: t.tm_hour += value; break;
+    case HOUR_AMPM: t.tm_hour += value; break;
+    case MINUTE: t.tm_min += value; break;
+    case SECOND: t.tm_sec += value; break;
+    }
+
+    result = mktime(&t);
+    return result != -1;
+}
+
+/*
+ * Valida no calendário gregoriano proléptico via timegm (sem fuso)
+ */
+bool refValidate(int day, int month, int year, int hour, int minute, int second){
+    if(hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 59)
+        return false;
+    if(month < 1 || month > 12 || day < 1 || day > 31)
+        return false;
+
+    tm t;
+    memset(&t, 0, sizeof t);
+    t.tm_mday = day;
+    t.tm_mon = month - 1;
+    t.tm_year = year - 1900;
+    t.tm_hour = 12;
+    timegm(&t);
+
+    return t.tm_mday == day && t.tm_mon == month - 1;
+}
+
+bool refMakeDate(int day, int month, int year, int hour, int minute, int second,
+    time_t& result){
+    if(!refValidate(day, month, year, hour, minute, second))
+        return false;
+
+    tm t;
+    memset(&t, 0, sizeof t);
+    t.tm_mday = day;
+    t.tm_mon = month - 1;
+    t.tm_year = year - 1900;
+    t.tm_hour = hour;
+    t.tm_min = minute;
+    t.tm_sec = second;
+    t.tm_isdst = -1;
+
+    result = mktime(&t);
+    return result != -1;
+}
+
+/***************************************************************************
+ * Comparações
+ ***************************************************************************/
+
+/*
+ * Compara a escrita ISO 8601 / RFC 3339 com strftime e a leitura de volta
+ */
+void checkIso(Date& date){
+    time_t seconds = date.getDateInSeconds();
+    int milliseconds = (int) (nextRandom() % 1000);
+    char buffer[DATE_ISO_MAX_LENGTH + 1];
+    string got;
+
+    for(int f = 0; f < 3; f++){
+        size_t length = formatIsoDate(seconds, milliseconds, isoFormats[f], buffer);
+        string expected = refIso(seconds, milliseconds, isoFormats[f]);
+        expect(string(buffer, length) == expected, "formatIsoDate", seconds,
+            format("%s: got \"%s\", expected \"%s\"", isoNames[f], buffer, expected.c_str()));
+
+        time_t parsed = 0;
+        int parsedMilliseconds = -1;
+        bool ok = parseIsoDate(buffer, length, isoFormats[f], parsed, parsedMilliseconds);
+        int expectedMilliseconds = (isoFormats[f] == DATE_RFC3339 ? milliseconds : 0);
+        expect(ok && parsed == seconds && parsedMilliseconds == expectedMilliseconds,
+            "parseIsoDate", seconds, format("%s \"%s\": got %lld.%03d (%d)", isoNames[f],
+            buffer, (long long) parsed, parsedMilliseconds, ok));
+
+        date.getStringDate(isoFormats[f], got);
+        expected = refIso(seconds, 0, isoFormats[f]);
+        expect(got == expected, "getStringDate", seconds,
+            format("%s: got \"%s\", expected \"%s\"", isoNames[f], got.c_str(), expected.c_str()));
+    }
+}
+
+/*
+ * Strings que parseIsoDate deve recusar, e formas alternativas aceitas
+ */
+void checkIsoParsing(){
+    const char* rejected[] = {
+        "2015-02-29T00:00:00Z", "2100-02-29T00:00:00Z", "2015-13-01T00:00:00Z",
+        "2015-00-01T00:00:00Z", "2015-03-00T00:00:00Z", "2015-03-05T24:00:00Z",
+        "2015-03-05T07:60:09Z", "2015-03-05T07:04:60Z", "2015-03-05T07:04:09",
+        "2015-03-05T07:04:09+01", "2015-03-05T07:04:09+0100", "2015-03-05T07:04:09+24:00",
+        "2015-03-05T07:04:09.Z", "2015-03-05T07:04:09.1234567890Z", "2015-03-05 07:04:09Z",
+        "2015-3-05T07:04:09Z", "2015-03-05T07:04:09Zx", "2O15-03-05T07:04:09Z",
+        "2015/03/05T07:04:09Z", "2015-03-05T07:04:09+01:0a", ""
+    };
+    time_t seconds;
+    int milliseconds;
+
+    for(size_t i = 0; i < sizeof rejected / sizeof rejected[0]; i++)
+        expect(!parseIsoDate(rejected[i], strlen(rejected[i]), DATE_RFC3339, seconds, milliseconds),
+            "parseIsoDate", 0, format("accepted \"%s\"", rejected[i]));
+
+    const char* basicRejected[] = {"20150305T070409+01:00", "2015-03-05T07:04:09Z", "20150305T0704Z"};
+    for(size_t i = 0; i < sizeof basicRejected / sizeof basicRejected[0]; i++)
+        expect(!parseIsoDate(basicRejected[i], strlen(basicRejected[i]), DATE_ISO8601_BASIC,
+            seconds, milliseconds), "parseIsoDate", 0, format("accepted \"%s\"", basicRejected[i]));
+
+    struct Accepted{
+        const char* text;
+        DateFormat dateFormat;
+        time_t seconds;
+        int milliseconds;
+    };
+    const Accepted accepted[] = {
+        {"2015-03-05T07:04:09.123+01:00", DATE_RFC3339, 1425535449, 123},
+        {"2015-03-05t06:04:09.1z", DATE_RFC3339, 1425535449, 100},
+        {"2015-03-05T06:04:09,123456789Z", DATE_ISO8601, 1425535449, 123},
+        {"2015-03-05T01:34:09-04:30", DATE_ISO8601, 1425535449, 0},
+        {"20150305T070409+0100", DATE_ISO8601_BASIC, 1425535449, 0},
+        {"20150305T060409.5Z", DATE_ISO8601_BASIC, 1425535449, 500},
+        {"1900-01-01T00:00:00Z", DATE_ISO8601, -2208988800LL, 0},
+        {"9999-12-31T23:59:59Z", DATE_ISO8601, 253402300799LL, 0}
+    };
+    for(size_t i = 0; i < sizeof accepted / sizeof accepted[0]; i++){
+        bool ok = parseIsoDate(accepted[i].text, strlen(accepted[i].text), accepted[i].dateFormat,
+            seconds, milliseconds);
+        expect(ok && seconds == accepted[i].seconds && milliseconds == accepted[i].milliseconds,
+            "parseIsoDate", accepted[i].seconds, format("\"%s\": got %lld.%03d (%d)",
+            accepted[i].text, (long long) seconds, milliseconds, ok));
+    }
+
+    Date date;
+    bool ok = date.setDate(string("2015-03-05T07:04:09.123+01:00"), DATE_RFC3339);
+    expect(ok && date.getDateInSeconds() == 1425535449, "setDate", 1425535449,
+        format("ISO string: got %lld (%d)", (long long) date.getDateInSeconds(), ok));
+    expect(!date.setDate(string("1969-12-31T23:59:59Z"), DATE_ISO8601), "setDate", -1,
+        "accepted ISO string before 1970");
+}
+
+/*
+ * Compara leitura, formatação e aritmética de uma data já configurada
+ */
+void checkDate(Date& date){
+    time_t seconds = date.getDateInSeconds();
+
+    for(int c = 0; c < 9; c++){
+        int got = date.getDateComponent(allComponents[c]);
+        int expected = refComponent(seconds, allComponents[c]);
+        expect(got == expected, "getDateComponent", seconds,
+            format("%s: got %d, expected %d", componentNames[c], got, expected));
+    }
+
+    string got;
+    for(int f = 0; f < 8; f++){
+        for(int week = 0; week < 2; week++){
+            date.getStringDate(allFormats[f], got, week != 0);
+            string expected = refString(seconds, allFormats[f], week != 0);
+            expect(got == expected, "getStringDate", seconds,
+                format("got \"%s\", expected \"%s\"", got.c_str(), expected.c_str()));
+        }
+    }
+
+    date.getStringWeek(got);
+    const char* expectedWeek = weekNames[refComponent(seconds, WDAY)];
+    expect(got == expectedWeek, "getStringWeek", seconds,
+        format("got \"%s\", expected \"%s\"", got.c_str(), expectedWeek));
+
+    checkIso(date);
+}
+
+/*
+ * Compara addDateComponent (somando e subtraindo) a partir de uma data
+ */
+void restoreDate(Date& date, time_t seconds){
+    // setDate(time_t) não aceita datas anteriores a 1970
+    if(date.setDate(seconds)) return;
+
+    tm t;
+    localtime_r(&seconds, &t);
+    date.setDate(t.tm_mday, t.tm_mon + 1, t.tm_year + 1900, t.tm_hour, t.tm_min, t.tm_sec);
+}
+
+void checkAdd(Date& date, DateComponent dateComponent, int value){
+    time_t original = date.getDateInSeconds();
+
+    for(int add = 0; add < 2; add++){
+        restoreDate(date, original);
+        time_t seconds = date.getDateInSeconds();
+        time_t expected = 0;
+        bool expectedOk = refAdd(seconds, dateComponent, add ? value : -value, expected);
+        bool gotOk = date.addDateComponent(dateComponent, value, add != 0);
+        time_t got = date.getDateInSeconds();
+
+        expect(gotOk == expectedOk && (!gotOk || got == expected), "addDateComponent",
+            seconds, format("%s %+d: got %lld (%d), expected %lld (%d)",
+            componentNames[dateComponent], add ? value : -value,
+            (long long) got, gotOk, (long long) expected, expectedOk));
+    }
+
+    restoreDate(date, original);
+}
+
+/*
+ * Todos os dias de 1900 a 2200 (inclusive dias inválidos como 31/4 e 29/2)
+ */
+void sweepDays(Date& date){
+    int step = 0;
+
+    for(int year = 1900; year <= 2200; year++){
+        for(int month = 1; month <= 12; month++){
+            for(int day = 1; day <= 31; day++){
+                // varia a hora para cair às vezes em transições de horário de verão
+                int hour = step % 24, minute = (step * 7) % 60, second = (step * 13) % 60;
+                step++;
+
+                bool expectedValid = refValidate(day, month, year, hour, minute, second);
+                bool gotValid = date.validateDate(day, month, year, hour, minute, second);
+                expect(gotValid == expectedValid, "validateDate", 0,
+                    format("%d/%d/%d %d:%d:%d: got %d, expected %d", day, month, year,
+                    hour, minute, second, gotValid, expectedValid));
+                if(!expectedValid) continue;
+
+                time_t expected = 0;
+                bool expectedOk = refMakeDate(day, month, year, hour, minute, second, expected);
+                bool gotOk = date.setDate(day, month, year, hour, minute, second);
+                bool same = gotOk == expectedOk && (!gotOk || date.getDateInSeconds() == expected);
+                expect(same, "setDate", expected, format("%d/%d/%d %d:%d:%d: got %lld (%d), "
+                    "expected %lld (%d)", day, month, year, hour, minute, second,
+                    (long long) date.getDateInSeconds(), gotOk, (long long) expected, expectedOk));
+                if(!same || !gotOk) continue;
+
+                checkDate(date);
+                if(day == 1 || day == 28 || day == 31){
+                    checkAdd(date, MDAY, 1);
+                    checkAdd(date, MONTH, 1);
+                    checkAdd(date, YEAR, 1);
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Acha o segundo exato em que o deslocamento UTC muda dentro de (low, high]
+ */
+time_t findTransition(time_t low, time_t high){
+    tm t;
+    localtime_r(&low, &t);
+    long offset = t.tm_gmtoff;
+
+    while(high - low > 1){
+        time_t middle = low + (high - low) / 2;
+        localtime_r(&middle, &t);
+        if(t.tm_gmtoff == offset) low = middle;
+        else high = middle;
+    }
+    return high;
+}
+
+/*
+ * Vizinhanças (±2 s) de viradas de dia, mês, ano, transições de horário
+ * de verão, da época e do limite de 32 bits
+ */
+void sweepBoundaries(Date& date){
+    vector<time_t> boundaries;
+    boundaries.push_back(0);
+    boundaries.push_back(2147483647);
+
+    tm t;
+    time_t end = 7258118400LL;  // 1/1/2200 UTC
+    long lastOffset = 0;
+    for(time_t day = 0; day < end; day += 86400){
+        localtime_r(&day, &t);
+        if(day > 0 && t.tm_gmtoff != lastOffset)
+            boundaries.push_back(findTransition(day - 86400, day));
+        lastOffset = t.tm_gmtoff;
+
+        // meia-noite local do dia
+        tm midnight = t;
+        midnight.tm_hour = midnight.tm_min = midnight.tm_sec = 0;
+        midnight.tm_isdst = -1;
+        if(t.tm_mday == 1 || t.tm_mday % 7 == 0)
+            boundaries.push_back(mktime(&midnight));
+    }
+
+    for(size_t i = 0; i < boundaries.size(); i++){
+        for(time_t delta = -2; delta <= 2; delta++){
+            time_t seconds = boundaries[i] + delta;
+            if(!date.setDate(seconds)) continue;
+            checkDate(date);
+            checkAdd(date, HOUR, 1);
+            checkAdd(date, MINUTE, 30);
+            checkAdd(date, MDAY, 1);
+        }
+    }
+}
+
+void sweepRandom(Date& date, size_t count){
+    for(size_t i = 0; i < count; i++){
+        time_t seconds = (time_t) (nextRandom() % 7258118400ULL);
+        date.setDate(seconds);
+        checkDate(date);
+
+        int c = (int) (nextRandom() % 9);
+        int value = (int) (nextRandom() % 801) - 400;
+        checkAdd(date, allComponents[c], value);
+    }
+}
+
+/*
+ * Operações de DateRangeSet contra um mapa de bits em um universo pequeno
+ */
+void checkRangeSets(){
+    const int universe = 200;
+
+    for(int round = 0; round < 2000; round++){
+        vector<DateRange> input[2];
+        vector<bool> bits[2];
+
+        for(int s = 0; s < 2; s++){
+            bits[s].assign(universe, false);
+            int count = (int) (nextRandom() % 12);
+            for(int i = 0; i < count; i++){
+                time_t start = (time_t) (nextRandom() % universe);
+                time_t end = start + (time_t) (nextRandom() % 40) - 5;
+                if(end > universe) end = universe;
+                input[s].push_back(DateRange(start, end));
+                for(time_t t = start; t < end; t++) bits[s][t] = true;
+            }
+        }
+
+        DateRangeSet a(input[0]), b(input[1]);
+        DateRangeSet added;
+        for(size_t i = 0; i < input[0].size(); i++)
+            added.add(input[0][i]);
+        expect(added.getRanges() == a.getRanges(), "DateRangeSet.add", round,
+            format("%lu ranges, bulk %lu", (unsigned long) added.size(), (unsigned long) a.size()));
+
+        DateRangeSet sets[3];
+        a.getUnion(b, sets[0]);
+        a.getIntersection(b, sets[1]);
+        a.getDifference(b, sets[2]);
+        const char* names[] = {"DateRangeSet.getUnion", "DateRangeSet.getIntersection",
+            "DateRangeSet.getDifference"};
+
+        for(int op = 0; op < 3; op++){
+            // normalizado: ordenado, sem vazios e sem intervalos que se tocam
+            bool normalized = true;
+            for(size_t i = 0; i < sets[op].size(); i++){
+                const DateRange& range = sets[op].getRange(i);
+                if(range.isEmpty() || (i > 0 && range.getStart() <= sets[op].getRange(i - 1).getEnd()))
+                    normalized = false;
+            }
+            expect(normalized, names[op], round, "result not normalized");
+
+            for(time_t t = 0; t < universe; t++){
+                bool expected = (op == 0 ? bits[0][t] || bits[1][t]
+                    : op == 1 ? bits[0][t] && bits[1][t] : bits[0][t] && !bits[1][t]);
+                if(!expect(sets[op].contains(t) == expected, names[op], t,
+                    format("round %d: contains %d", round, !expected)))
+                    break;
+            }
+        }
+
+        // consultas de intervalo contra o mapa de bits
+        for(int q = 0; q < 20; q++){
+            time_t start = (time_t) (nextRandom() % universe);
+            time_t end = start + (time_t) (nextRandom() % 30);
+            if(end > universe) end = universe;
+            bool all = start < end, any = false;
+            for(time_t t = start; t < end; t++){
+                if(bits[0][t]) any = true;
+                else all = false;
+            }
+            DateRange range(start, end);
+            expect(a.contains(range) == all, "DateRangeSet.contains", start,
+                format("[%ld, %ld): got %d", (long) start, (long) end, !all));
+            expect(a.overlaps(range) == any, "DateRangeSet.overlaps", start,
+                format("[%ld, %ld): got %d", (long) start, (long) end, !any));
+        }
+
+        // resultado no próprio operando
+        DateRangeSet aliased(input[0]);
+        aliased.getUnion(b, aliased);
+        expect(aliased.getRanges() == sets[0].getRanges(), "DateRangeSet.getUnion", round,
+            "aliased result differs");
+    }
+}
+
+/*
+ * Chave do calendário local (hora, dia, mês ou ano) de um instante
+ */
+long long localKey(time_t seconds, DateComponent dateComponent){
+    tm t;
+    localtime_r(&seconds, &t);
+    long long days = (long long) timegm(&t) / 86400;
 
+    switch(dateComponent){
+    case HOUR: return days * 24 + t.tm_hour;
+    case MONTH: return (t.tm_year + 1900LL) * 12 + t.tm_mon;
+    case YEAR: return t.tm_year + 1900LL;
+    default: return days;
+    }
+}
+
+/*
+ * DateRange::split: partes contíguas, cada uma com uma só chave local e
+ * terminando onde a chave aumenta; intervalos curtos também são varridos
+ * minuto a minuto
+ */
+void checkSplit(size_t count){
+    const DateComponent units[] = {HOUR, MDAY, MONTH, YEAR};
+    const time_t spans[] = {3 * 86400, 60 * 86400, 3 * 366 * 86400, 40 * 366 * 86400};
+
+    for(size_t i = 0; i < count; i++){
+        int u = (int) (i % 4);
+        time_t start = (time_t) (nextRandom() % 4102444800ULL);
+        time_t end = start + (time_t) (nextRandom() % spans[u]);
+        DateRange range(start, end);
+        vector<DateRange> parts;
+
+        if(!expect(range.split(units[u], parts), "DateRange.split", start, "returned false"))
+            continue;
+
+        time_t current = start;
+        for(size_t p = 0; p < parts.size(); p++){
+            const DateRange& part = parts[p];
+            bool ok = part.getStart() == current && !part.isEmpty()
+                && localKey(part.getStart(), units[u]) == localKey(part.getEnd() - 1, units[u])
+                && (part.getEnd() == end
+                    || localKey(part.getEnd(), units[u]) > localKey(part.getEnd() - 1, units[u]));
+            if(!expect(ok, "DateRange.split", part.getStart(), format("%s part [%lld, %lld) of "
+                "[%lld, %lld)", componentNames[units[u]], (long long) part.getStart(),
+                (long long) part.getEnd(), (long long) start, (long long) end)))
+                break;
+            current = part.getEnd();
+        }
+        expect(current == end || (parts.empty() && start == end), "DateRange.split", start,
+            "parts do not cover the range");
+
+        // varredura por minuto: cada parte termina na primeira mudança de chave
+        if(units[u] == HOUR || (units[u] == MDAY && end - start < 4 * 86400)){
+            size_t p = 0;
+            long long key = localKey(start, units[u]);
+            for(time_t t = start + 60 - start % 60; t < end && p < parts.size(); t += 60){
+                long long next = localKey(t, units[u]);
+                if(next == key) continue;
+                if(!expect(parts[p].getEnd() == t, "DateRange.split", t,
+                    format("%s boundary at %lld", componentNames[units[u]],
+                    (long long) parts[p].getEnd())))
+                    break;
+                key = next;
+                p++;
+            }
+        }
+    }
+
+    DateRange empty(10, 10);
+    vector<DateRange> parts;
+    expect(empty.split(MDAY, parts) && parts.empty(), "DateRange.split", 10, "empty range");
+    expect(!empty.split(MINUTE, parts), "DateRange.split", 10, "accepted MINUTE");
+}
+
+/*
+ * DateStringColumn: cada elemento igual à referência, com 1 e 4 threads
+ */
+void checkColumn(size_t count){
+    vector<time_t> samples(count);
+    for(size_t i = 0; i < count; i++)
+        samples[i] = (time_t) (nextRandom() % 9466848000ULL) - 2208988800LL;
+
+    DateStringColumn column;
+    const DateFormat formats[] = {
+        DATE_DMY, DATE_YMD, DATE_HMS, DATE_HMS_AMPM, DATE_DMY_HMS, DATE_YMD_HMS,
+        DATE_DMY_HMS_AMPM, DATE_YMD_HMS_AMPM, DATE_ISO8601_BASIC, DATE_ISO8601, DATE_RFC3339
+    };
+
+    for(int f = 0; f < 11; f++){
+        for(int run = 0; run < 4; run++){
+            bool showWeek = (run % 2 == 0);
+            unsigned threads = (run < 2 ? 1 : 4);
+            bool ok = column.format(&samples[0], count, formats[f], showWeek, threads);
+            expect(ok && column.size() == count && column.getOffsets()[0] == 0,
+                "DateStringColumn.format", 0, format("format %d returned %d", f, ok));
+
+            string got;
+            for(size_t i = 0; i < column.size(); i++){
+                column.getString(i, got);
+                string expected = refString(samples[i], formats[f], showWeek);
+                if(!expect(got == expected, "DateStringColumn.format", samples[i],
+                    format("%u threads: got \"%s\", expected \"%s\"", threads,
+                    got.c_str(), expected.c_str())))
+                    break;
+            }
+            expect((size_t) column.getOffsets()[count] == column.getDataLength(),
+                "DateStringColumn.format", 0, "last offset differs from data length");
+        }
+    }
+}
+
+/*
+ * DateOnly: dias aleatórios de 1900 a 2200 comparados com o meio-dia local
+ * do mesmo dia
+ */
+void checkDateOnly(Date& date, size_t count){
+    const DateFormat formats[] = {DATE_DMY, DATE_YMD};
+
+    expect(sizeof(DateOnly) == 4, "DateOnly.sizeof", 0, format("%d bytes", (int) sizeof(DateOnly)));
+
+    for(size_t i = 0; i < count; i++){
+        long long days = (long long) (nextRandom() % 109938) - 25567;
+        time_t utc = (time_t) (days * 86400);
+        tm t;
+        gmtime_r(&utc, &t);
+        int day = t.tm_mday, month = t.tm_mon + 1, year = t.tm_year + 1900;
+
+        time_t noon, midnight;
+        if(!refMakeDate(day, month, year, 12, 0, 0, noon))
+            continue;
+
+        DateOnly only(day, month, year);
+        if(!expect(only.getDateInDays() == days, "DateOnly.setDate", noon,
+            format("%d/%d/%d: got %d, expected %lld", day, month, year, only.getDateInDays(), days)))
+            continue;
+
+        for(int c = 0; c < 9; c++){
+            int expected = c < 5 ? refComponent(noon, allComponents[c]) : -1;
+            int got = only.getDateComponent(allComponents[c]);
+            expect(got == expected, "DateOnly.getDateComponent", noon,
+                format("%s: got %d, expected %d", componentNames[c], got, expected));
+        }
+
+        string got;
+        for(int f = 0; f < 4; f++){
+            only.getStringDate(formats[f / 2], got, f % 2 == 0);
+            string expected = refString(noon, formats[f / 2], f % 2 == 0);
+            expect(got == expected, "DateOnly.getStringDate", noon,
+                format("got \"%s\", expected \"%s\"", got.c_str(), expected.c_str()));
+        }
+
+        // aritmética igual à de Date (mktime) ao meio-dia
+        DateComponent dateComponent = allComponents[i % 5];
+        int value = (int) (nextRandom() % 81) - 40;
+        DateOnly added(only);
+        time_t expected;
+        if(refAdd(noon, dateComponent, value, expected) && added.addDateComponent(dateComponent, value)){
+            bool ok = added.getDateComponent(MDAY) == refComponent(expected, MDAY)
+                && added.getDateComponent(MONTH) == refComponent(expected, MONTH)
+                && added.getDateComponent(YEAR) == refComponent(expected, YEAR);
+            expect(ok, "DateOnly.addDateComponent", noon, format("%s %+d: got %d/%d/%d",
+                componentNames[i % 5], value, added.getDateComponent(MDAY),
+                added.getDateComponent(MONTH), added.getDateComponent(YEAR)));
+        }
+
+        // conversões de/para Date
+        if(date.setDate(day, month, year, 12, 0, 0)){
+            DateOnly converted(date);
+            expect(converted == only, "DateOnly.setDate(Date)", noon,
+                format("got %d", converted.getDateInDays()));
+        }
+        if(refMakeDate(day, month, year, 0, 0, 0, midnight)){
+            bool ok = only.getDate(date) && date.getDateInSeconds() == midnight;
+            expect(ok, "DateOnly.getDate", midnight,
+                format("got %lld", (long long) date.getDateInSeconds()));
+        }
+    }
+
+    DateOnly only(1, 1, 2000);
+    expect(!only.setDate(31, 4, 2000) && !only.setDate(29, 2, 1900) && only.setDate(29, 2, 2000),
+        "DateOnly.validateDate", 0, "invalid day accepted");
+}
+
+/*
+ * TimeOfDay: horas aleatórias comparadas com a aritmética e com Date em um
+ * dia sem transição de horário de verão
+ */
+void checkTimeOfDay(Date& date, size_t count){
+    expect(sizeof(TimeOfDay) == 4, "TimeOfDay.sizeof", 0,
+        format("%d bytes", (int) sizeof(TimeOfDay)));
+
+    TimeOfDay time(0);
+    for(size_t i = 0; i < count; i++){
+        int32_t milliseconds = (int32_t) (nextRandom() % 86400000);
+        int hour = milliseconds / 3600000, minute = milliseconds / 60000 % 60;
+        int second = milliseconds / 1000 % 60;
+
+        time.setTimeInMilliseconds(milliseconds);
+        bool ok = time.getDateComponent(HOUR) == hour && time.getDateComponent(MINUTE) == minute
+            && time.getDateComponent(SECOND) == second
+            && time.getMillisecond() == milliseconds % 1000
+            && time.getDateComponent(MDAY) == -1
+            && TimeOfDay(hour, minute, second, milliseconds % 1000) == time;
+        expect(ok, "TimeOfDay.getDateComponent", 0, format("%d ms", milliseconds));
+
+        time_t instant;
+        if(!refMakeDate(15, 1, 2015, hour, minute, second, instant))
+            continue;
+
+        string got;
+        for(int f = DATE_HMS; f <= DATE_HMS_AMPM; f++){
+            time.getStringDate((DateFormat) f, got);
+            string expected = refString(instant, (DateFormat) f, false);
+            expect(got == expected, "TimeOfDay.getStringDate", instant,
+                format("got \"%s\", expected \"%s\"", got.c_str(), expected.c_str()));
+        }
+
+        // conversões de/para Date
+        date.setDate(15, 1, 2015, hour, minute, second);
+        expect(TimeOfDay(date).getTimeInMilliseconds() == milliseconds - milliseconds % 1000,
+            "TimeOfDay.setTime(Date)", instant, "differs");
+        time_t expected;
+        if(date.setDate(20, 6, 2015, 10, 0, 0) && refMakeDate(20, 6, 2015, hour, minute, second, expected))
+            expect(time.getDate(date) && date.getDateInSeconds() == expected, "TimeOfDay.getDate",
+                expected, format("got %lld", (long long) date.getDateInSeconds()));
+
+        // soma dá a volta na meia-noite
+        const DateComponent adds[] = {HOUR, MINUTE, SECOND};
+        const long long units[] = {3600000, 60000, 1000};
+        int value = (int) (nextRandom() % 200001) - 100000;
+        TimeOfDay added(time);
+        long long wrapped = ((milliseconds + value * units[i % 3]) % 86400000 + 86400000) % 86400000;
+        expect(added.addDateComponent(adds[i % 3], value) && added.getTimeInMilliseconds() == wrapped,
+            "TimeOfDay.addDateComponent", 0, format("%d ms %+d: got %d", milliseconds, value,
+            added.getTimeInMilliseconds()));
+    }
+
+    expect(!time.setTime(24) && !time.setTime(0, 60) && !time.setTimeInMilliseconds(86400000)
+        && !time.addDateComponent(MDAY, 1), "TimeOfDay.validateTime", 0, "invalid time accepted");
+}
+
+/*
+ * DateFormatter: sequências crescentes com passos curtos, alguns recuos e
+ * saltos, parte delas atravessando transições de horário de verão; cada
+ * texto igual à referência
+ */
+void checkFormatter(size_t count){
+    const DateFormat formats[] = {
+        DATE_DMY, DATE_YMD, DATE_HMS, DATE_HMS_AMPM, DATE_DMY_HMS, DATE_YMD_HMS,
+        DATE_DMY_HMS_AMPM, DATE_YMD_HMS_AMPM, DATE_ISO8601_BASIC, DATE_ISO8601, DATE_RFC3339
+    };
+
+    // transições de 1900 a 2100
+    vector<time_t> transitions;
+    tm t;
+    long lastOffset = 0;
+    for(time_t day = -2208988800LL; day < 4102444800LL; day += 86400){
+        localtime_r(&day, &t);
+        if(day > -2208988800LL && t.tm_gmtoff != lastOffset)
+            transitions.push_back(findTransition(day - 86400, day));
+        lastOffset = t.tm_gmtoff;
+    }
+
+    for(int f = 0; f < 11; f++){
+        for(int week = 0; week < 2; week++){
+            DateFormatter formatter(formats[f], week == 0);
+            time_t seconds;
+            if(!transitions.empty() && nextRandom() % 2)
+                seconds = transitions[nextRandom() % transitions.size()] - 3 * 3600;
+            else
+                seconds = (time_t) (nextRandom() % 9466848000ULL) - 2208988800LL;
+
+            for(size_t i = 0; i < count; i++){
+                uint64_t r = nextRandom();
+                if(r % 64 == 0) seconds += (time_t) (r >> 8) % (3 * 86400);
+                else if(r % 16 == 0) seconds -= (time_t) (r >> 8) % 120;
+                else seconds += (time_t) (r >> 8) % 90;
+                int milliseconds = (r % 4 == 0 ? 0 : (int) ((r >> 40) % 1000));
+
+                string got = formatter.format(seconds, milliseconds);
+                string expected = (formats[f] == DATE_RFC3339
+                    ? refIso(seconds, milliseconds, formats[f])
+                    : refString(seconds, formats[f], week == 0));
+                if(!expect(got == expected && formatter.getLength() == got.size(),
+                    "DateFormatter.format", seconds, format("got \"%s\", expected \"%s\"",
+                    got.c_str(), expected.c_str())))
+                    break;
+            }
+        }
+    }
+
+    // um dia sem transição: só a primeira data é formatada por completo
+    time_t noon;
+    if(refMakeDate(15, 1, 2015, 12, 0, 0, noon)){
+        DateFormatter formatter(DATE_DMY_HMS_AMPM);
+        string text;
+        for(time_t seconds = noon; seconds < noon + 10000; seconds++)
+            formatter.getStringDate(seconds, text);
+        expect(formatter.getFullRenderCount() == 1 && text == refString(noon + 9999,
+            DATE_DMY_HMS_AMPM, true), "DateFormatter.fullRenders", noon,
+            format("%lu full renders", (unsigned long) formatter.getFullRenderCount()));
+    }
+
+    // milissegundos inválidos geram texto vazio sem estragar a data guardada
+    DateFormatter formatter(DATE_RFC3339);
+    formatter.format(1000000000, 5);
+    bool ok = formatter.format(1000000000, 1000)[0] == '\0'
+        && formatter.format(1000000001, 5) == refIso(1000000001, 5, DATE_RFC3339);
+    expect(ok, "DateFormatter.format", 1000000000, "invalid milliseconds");
+}
+
+/*
+ * Temporizador usado em checkTimerWheel(): registra a chamada e executa
+ * uma ação (cancelar outro temporizador ou se reagendar)
+ */
+struct TimerProbe{
+    TimerWheel* wheel;
+    vector<int>* log;
+    int label;
+    // temporizador a cancelar no callback (0 = nenhum)
+    TimerId cancelId;
+    bool cancelResult;
+    // reagendamentos restantes e intervalo entre eles
+    int reschedules;
+    time_t interval;
+    // chamadas fora da data agendada
+    int late;
+};
+
+void onProbe(time_t seconds, void* userData){
+    TimerProbe* probe = (TimerProbe*) userData;
+    probe->log->push_back(probe->label);
+    if(seconds != probe->wheel->getCurrentTime())
+        probe->late++;
+    if(probe->cancelId)
+        probe->cancelResult = probe->wheel->cancel(probe->cancelId);
+    if(probe->reschedules > 0){
+        probe->reschedules--;
+        probe->wheel->schedule(seconds + probe->interval, onProbe, probe);
+    }
+}
+
+TimerProbe makeProbe(TimerWheel* wheel, vector<int>* log, int label){
+    TimerProbe probe = {wheel, log, label, 0, false, 0, 0, 0};
+    return probe;
+}
+
+string formatLog(const vector<int>& log){
+    string text;
+    for(size_t i = 0; i < log.size(); i++)
+        text += format(i ? ",%d" : "%d", log[i]);
+    return text;
+}
+
+/*
+ * TimerWheel: cancelamento dentro do lote, datas passadas, estouro do
+ * último nível, ids antigos e reagendamento nos callbacks
+ */
+void checkTimerWheel(size_t count){
+    const time_t origin = 1000000;
+    vector<int> log;
+
+    // dois temporizadores no mesmo segundo, cada um cancela o outro:
+    // só o primeiro a ser chamado executa
+    {
+        TimerWheel wheel(origin);
+        TimerProbe a = makeProbe(&wheel, &log, 1), b = makeProbe(&wheel, &log, 2);
+        TimerId idA = wheel.schedule(origin + 200, onProbe, &a);
+        TimerId idB = wheel.schedule(origin + 200, onProbe, &b);
+        a.cancelId = idB;
+        b.cancelId = idA;
+        log.clear();
+        size_t fired = wheel.advance(origin + 300);
+        bool ok = fired == 1 && log.size() == 1 && (log[0] == 1 ? a.cancelResult : b.cancelResult)
+            && wheel.size() == 0;
+        expect(ok, "TimerWheel.cancelInBatch", origin + 200, format("fired %s (returned %lu)",
+            formatLog(log).c_str(), (unsigned long) fired));
+    }
+
+    // datas que já passaram saem em ordem de data; iguais, na ordem de agendamento
+    {
+        TimerWheel wheel(origin);
+        const time_t past[] = {500, 300, 900, 300, origin};
+        TimerProbe probes[5];
+        for(int i = 0; i < 5; i++){
+            probes[i] = makeProbe(&wheel, &log, i);
+            wheel.schedule(past[i], onProbe, &probes[i]);
+        }
+        log.clear();
+        wheel.advance(origin);
+        expect(formatLog(log) == "1,3,0,2,4", "TimerWheel.past", origin,
+            format("fired %s, expected 1,3,0,2,4", formatLog(log).c_str()));
+    }
+
+    // além de 2^30 s (lista de estouro), misturados com datas próximas
+    {
+        TimerWheel wheel(origin);
+        const time_t offsets[] = {3 * (1LL << 30) + 7, 5, (1LL << 30) + 12345, (1LL << 30) - 1,
+            (1LL << 36) + 1};
+        TimerProbe probes[5];
+        for(int i = 0; i < 5; i++){
+            probes[i] = makeProbe(&wheel, &log, i);
+            wheel.schedule(origin + offsets[i], onProbe, &probes[i]);
+        }
+        log.clear();
+        size_t fired = wheel.advance(origin + (1LL << 33));
+        int late = 0;
+        for(int i = 0; i < 5; i++) late += probes[i].late;
+        expect(fired == 4 && formatLog(log) == "1,3,2,0" && late == 0 && wheel.size() == 1,
+            "TimerWheel.overflow", origin, format("fired %s, %d late", formatLog(log).c_str(), late));
+        fired = wheel.advance(origin + (1LL << 37));
+        expect(fired == 1 && probes[4].late == 0 && wheel.size() == 0, "TimerWheel.overflow",
+            origin + (1LL << 36) + 1, "last timer");
+    }
+
+    // ids cancelados, vencidos ou de nós reaproveitados não valem mais
+    {
+        TimerWheel wheel(origin);
+        TimerProbe a = makeProbe(&wheel, &log, 1);
+        TimerId first = wheel.schedule(origin + 10, onProbe, &a);
+        bool ok = wheel.cancel(first) && !wheel.cancel(first);
+        TimerId second = wheel.schedule(origin + 10, onProbe, &a);
+        ok = ok && second != first && !wheel.cancel(first) && wheel.size() == 1;
+        ok = ok && !wheel.cancel(0) && !wheel.cancel(((TimerId) 1 << 32) | 12345);
+        log.clear();
+        wheel.advance(origin + 20);
+        ok = ok && log.size() == 1 && !wheel.cancel(second) && wheel.size() == 0;
+        expect(ok, "TimerWheel.staleCancel", origin, "stale id accepted");
+    }
+
+    // callbacks que se reagendam e que cancelam a si mesmos
+    {
+        TimerWheel wheel(origin);
+        TimerProbe a = makeProbe(&wheel, &log, 1), b = makeProbe(&wheel, &log, 2);
+        a.reschedules = 3;
+        a.interval = 10;
+        wheel.schedule(origin + 100, onProbe, &a);
+        b.cancelId = wheel.schedule(origin + 105, onProbe, &b);
+        log.clear();
+        size_t fired = wheel.advance(origin + 1000);
+        bool ok = fired == 5 && formatLog(log) == "1,2,1,1,1" && a.late == 0
+            && b.cancelResult && wheel.size() == 0;
+
+        // a lista de livres continua consistente
+        TimerProbe c = makeProbe(&wheel, &log, 3), d = makeProbe(&wheel, &log, 4);
+        TimerId idC = wheel.schedule(origin + 1001, onProbe, &c);
+        TimerId idD = wheel.schedule(origin + 1002, onProbe, &d);
+        log.clear();
+        ok = ok && idC != idD && wheel.advance(origin + 2000) == 2 && formatLog(log) == "3,4";
+        expect(ok, "TimerWheel.reschedule", origin, format("fired %s", formatLog(log).c_str()));
+    }
+
+    // callback que se reagenda para o próprio segundo: vence no mesmo
+    // advance(), antes dos temporizadores seguintes
+    {
+        TimerWheel wheel(origin);
+        TimerProbe a = makeProbe(&wheel, &log, 1), b = makeProbe(&wheel, &log, 2),
+            c = makeProbe(&wheel, &log, 3);
+        a.reschedules = 1;
+        b.reschedules = 1;
+        b.interval = 2;
+        wheel.schedule(origin + 5, onProbe, &a);
+        wheel.schedule(origin + 4, onProbe, &b);
+        wheel.schedule(origin + 10, onProbe, &c);
+        log.clear();
+        size_t fired = wheel.advance(origin + 100);
+        bool ok = fired == 5 && formatLog(log) == "2,1,1,2,3" && a.late + b.late + c.late == 0
+            && wheel.size() == 0;
+        expect(ok, "TimerWheel.rescheduleNow", origin + 5,
+            format("fired %s, expected 2,1,1,2,3", formatLog(log).c_str()));
+    }
+
+    // aleatório: datas em várias escalas (até o estouro), 10% cancelados,
+    // avanços de tamanho aleatório; cada um chamado uma vez, na sua data
+    TimerWheel wheel(origin);
+    vector<TimerProbe> probes(count);
+    vector<TimerId> ids(count);
+    vector<time_t> expected;
+    for(size_t i = 0; i < count; i++){
+        probes[i] = makeProbe(&wheel, &log, (int) i);
+        time_t when = origin + (time_t) (nextRandom() % ((uint64_t) 1 << (nextRandom() % 36)));
+        ids[i] = wheel.schedule(when, onProbe, &probes[i]);
+        expected.push_back(when);
+    }
+    vector<bool> cancelled(count, false);
+    for(size_t i = 0; i < count; i += 10)
+        cancelled[i] = wheel.cancel(ids[i]);
+
+    log.clear();
+    time_t current = origin;
+    while(wheel.size() > 0 && current < origin + ((time_t) 1 << 37))
+        wheel.advance(current += (time_t) (nextRandom() % ((uint64_t) 1 << (nextRandom() % 34))));
+
+    vector<int> calls(count, 0);
+    bool ok = true;
+    for(size_t i = 0; i < log.size(); i++){
+        int label = log[i];
+        calls[label]++;
+        if(i > 0 && expected[label] < expected[log[i - 1]]) ok = false;
+    }
+    for(size_t i = 0; i < count; i++){
+        // os agendados no próprio relógio inicial saem pela lista de vencidos
+        bool late = probes[i].late > 0 && expected[i] != origin;
+        if(calls[i] != (cancelled[i] ? 0 : 1) || late) ok = false;
+    }
+    expect(ok && wheel.size() == 0, "TimerWheel.random", origin, "timers out of order, missing "
+        "or called twice");
+}
+
+void setZone(const char* zone){
+    setenv("TZ", zone, 1);
+    tzset();
+    currentZone = zone;
+}
+
+/***************************************************************************
+ * Medições
+ ***************************************************************************/
+
+void benchDate(size_t count){
+    vector<time_t> samples(count);
+    for(size_t i = 0; i < count; i++)
+        samples[i] = (time_t) (nextRandom() % 4102444800ULL);
+
+    Date date;
+    string text;
+    long long sum = 0;
+    clock_t start, end;
+
+    start = clock();
+    for(size_t i = 0; i < count; i++){
+        date.setDate(samples[i]);
+        for(int c = 0; c < 9; c++)
+            sum += date.getDateComponent(allComponents[c]);
+    }
+    end = clock();
+    recordPerf("date.getDateComponent", nsPerOp(start, end, count * 9));
+
+    start = clock();
+    for(size_t i = 0; i < count; i++){
+        date.setDate(samples[i]);
+        date.getStringDate(allFormats[i % 8], text);
+        sum += text.size();
+    }
+    end = clock();
+    recordPerf("date.getStringDate", nsPerOp(start, end, count));
+
+    start = clock();
+    for(size_t i = 0; i < count; i++){
+        date.setDate(samples[i]);
+        date.addDateComponent(allComponents[i % 9], 17);
+        sum += date.getDateInSeconds();
+    }
+    end = clock();
+    recordPerf("date.addDateComponent", nsPerOp(start, end, count));
+
+    start = clock();
+    for(size_t i = 0; i < count; i++)
+        sum += date.validateDate((int) (i % 32), (int) (i % 13), 1900 + (int) (i % 300));
+    end = clock();
+    recordPerf("date.validateDate", nsPerOp(start, end, count));
+
+    // referências da libc, para comparação
+    tm t;
+    start = clock();
+    for(size_t i = 0; i < count; i++){
+        localtime_r(&samples[i], &t);
+        sum += t.tm_mday;
+    }
+    end = clock();
+    recordPerf("libc.localtime_r", nsPerOp(start, end, count));
+
+    start = clock();
+    for(size_t i = 0; i < count; i++){
+        localtime_r(&samples[i], &t);
+        t.tm_mday += 17;
+        sum += mktime(&t);
+    }
+    end = clock();
+    recordPerf("libc.localtime_r+mktime", nsPerOp(start, end, count));
+
+    // coluna inteira de uma vez, contra um getStringDate por data; em tempo
+    // real (clock() soma o tempo de CPU de todas as threads). A primeira
+    // chamada inclui a alocação dos buffers; as seguintes os reaproveitam
+    double wallStart, wallEnd;
+    for(int threads = 1; threads <= 4; threads *= 4){
+        DateStringColumn column;
+        wallStart = getWallSeconds();
+        column.format(&samples[0], count, DATE_DMY_HMS, true, threads);
+        wallEnd = getWallSeconds();
+        sum += column.getDataLength();
+        recordPerf(format("column.format.cold(%d)", threads), nsPerOpWall(wallStart, wallEnd, count));
+
+        wallStart = getWallSeconds();
+        for(int run = 0; run < 3; run++){
+            column.format(&samples[0], count, DATE_DMY_HMS, true, threads);
+            sum += column.getDataLength();
+        }
+        wallEnd = getWallSeconds();
+        recordPerf(format("column.format(%d)", threads), nsPerOpWall(wallStart, wallEnd, count * 3));
+    }
+
+    wallStart = getWallSeconds();
+    for(size_t i = 0; i < count; i++){
+        date.setDate(samples[i]);
+        date.getStringDate(DATE_DMY_HMS, text);
+        sum += text.size();
+    }
+    wallEnd = getWallSeconds();
+    recordPerf("date.getStringDate(column)", nsPerOpWall(wallStart, wallEnd, count));
+
+    // ISO 8601 / RFC 3339 contra strftime / strptime
+    vector<char> texts(count * (DATE_ISO_MAX_LENGTH + 1));
+    char buffer[64];
+
+    start = clock();
+    for(size_t i = 0; i < count; i++)
+        sum += formatIsoDate(samples[i], (int) (i % 1000), DATE_RFC3339,
+            &texts[i * (DATE_ISO_MAX_LENGTH + 1)]);
+    end = clock();
+    recordPerf("iso.formatIsoDate", nsPerOp(start, end, count));
+
+    start = clock();
+    for(size_t i = 0; i < count; i++){
+        localtime_r(&samples[i], &t);
+        sum += strftime(buffer, sizeof buffer, "%Y-%m-%dT%H:%M:%S%z", &t);
+    }
+    end = clock();
+    recordPerf("libc.strftime", nsPerOp(start, end, count));
+
+    time_t parsed;
+    int milliseconds;
+    start = clock();
+    for(size_t i = 0; i < count; i++){
+        const char* text = &texts[i * (DATE_ISO_MAX_LENGTH + 1)];
+        parseIsoDate(text, DATE_ISO_MAX_LENGTH, DATE_RFC3339, parsed, milliseconds);
+        sum += parsed + milliseconds;
+    }
+    end = clock();
+    recordPerf("iso.parseIsoDate", nsPerOp(start, end, count));
+
+    // o mesmo trabalho de parseIsoDate(): fração e deslocamento UTC (%z da
+    // glibc aceita +hh:mm e Z), descontado do timegm
+    start = clock();
+    for(size_t i = 0; i < count; i++){
+        memset(&t, 0, sizeof t);
+        const char* p = strptime(&texts[i * (DATE_ISO_MAX_LENGTH + 1)], "%Y-%m-%dT%H:%M:%S", &t);
+        milliseconds = 0;
+        if(p && *p == '.'){
+            char* fractionEnd;
+            milliseconds = (int) strtol(p + 1, &fractionEnd, 10);
+            p = fractionEnd;
+        }
+        if(p) p = strptime(p, "%z", &t);
+        // timegm zera tm_gmtoff: lê antes
+        long offset = t.tm_gmtoff;
+        sum += (p ? timegm(&t) - offset : 0) + milliseconds;
+    }
+    end = clock();
+    recordPerf("libc.strptime+timegm", nsPerOp(start, end, count));
+
+    // formatação incremental contra formatDate(), em sequências ordenadas
+    // (passos de 0 a 2 s), quase ordenadas (vizinhas trocadas e recuos
+    // curtos) e aleatórias
+    vector<time_t> sorted(count), nearlySorted(count);
+    time_t current = 1420070400;
+    for(size_t i = 0; i < count; i++){
+        current += (time_t) (nextRandom() % 3);
+        sorted[i] = nearlySorted[i] = current;
+    }
+    for(size_t i = 1; i < count; i++){
+        uint64_t r = nextRandom();
+        if(r % 8 == 0) std::swap(nearlySorted[i - 1], nearlySorted[i]);
+        else if(r % 8 == 1) nearlySorted[i] -= (time_t) ((r >> 8) % 30);
+    }
+
+    const vector<time_t>* streams[] = {&sorted, &nearlySorted, &samples};
+    const char* streamNames[] = {"sorted", "nearly-sorted", "random"};
+    for(int s = 0; s < 3; s++){
+        const vector<time_t>& stream = *streams[s];
+        DateFormatter formatter(DATE_DMY_HMS);
+
+        start = clock();
+        for(size_t i = 0; i < count; i++){
+            formatter.format(stream[i]);
+            sum += formatter.getLength();
+        }
+        end = clock();
+        recordPerf(format("formatter.%s", streamNames[s]), nsPerOp(start, end, count));
+
+        start = clock();
+        for(size_t i = 0; i < count; i++)
+            sum += formatDate(stream[i], DATE_DMY_HMS, buffer);
+        end = clock();
+        recordPerf(format("formatDate.%s", streamNames[s]), nsPerOp(start, end, count));
+    }
+
+    perfSink = sum;
+}
+
+/*
+ * Estado verificado pelos callbacks do benchmark da roda
+ */
+struct WheelCheck{
+    TimerWheel* wheel;
+    time_t last;
+    size_t fired;
+    bool ordered;
+};
+
+void onTimer(time_t seconds, void* userData){
+    WheelCheck* check = (WheelCheck*) userData;
+    if(seconds < check->last || seconds > check->wheel->getCurrentTime())
+        check->ordered = false;
+    check->last = seconds;
+    check->fired++;
+}
+
+/*
+ * Insere, cancela (10%) e expira temporizadores espalhados em 30 dias
+ */
+bool benchTimerWheel(size_t timers){
+    Date start(1,1,2015);
+    time_t origin = start.getDateInSeconds();
+    const time_t span = 30 * 24 * 3600;
+
+    TimerWheel wheel(origin);
+    wheel.reserve(timers);
+    WheelCheck check = {&wheel, origin, 0, true};
+
+    vector<TimerId> ids(timers);
+
+    clock_t t0 = clock();
+    for(size_t i = 0; i < timers; i++){
+        time_t when = origin + 1 + (time_t) (nextRandom() % span);
+        ids[i] = wheel.schedule(when, onTimer, &check);
+    }
+    clock_t t1 = clock();
+
+    size_t cancelled = 0;
+    for(size_t i = 0; i < timers; i += 10)
+        if(wheel.cancel(ids[i])) cancelled++;
+    clock_t t2 = clock();
+
+    size_t fired = wheel.advance(origin + span + 1);
+    clock_t t3 = clock();
+
+    recordPerf("timerwheel.schedule", nsPerOp(t0, t1, timers));
+    recordPerf("timerwheel.cancel", nsPerOp(t1, t2, cancelled));
+    recordPerf("timerwheel.expire", nsPerOp(t2, t3, fired));
+
+    bool ok = check.ordered && fired == timers - cancelled
+        && check.fired == fired && wheel.size() == 0;
+    if(!ok)
+        printf("  FAIL timerwheel: fired %lu, expected %lu\n",
+            (unsigned long) fired, (unsigned long) (timers - cancelled));
+    return ok;
+}
+
+/***************************************************************************
+ * Baseline
+ ***************************************************************************/
+
+/*
+ * Compara os tempos com um baseline<BR>
+ * As medições da libc não são verificadas: servem de referência da
+ * velocidade da máquina. O baseline é escalado pela razão entre o
+ * libc.localtime_r atual e o do baseline, para que uma máquina
+ * momentaneamente mais lenta (ou mais rápida) não pareça uma regressão
+ */
+bool compareBaseline(const char* path, double margin){
+    FILE* file = fopen(path, "r");
+    if(!file){
+        printf("baseline %s not found\n", path);
+        return false;
+    }
+
+    map<string, double> baseline;
+    char name[128];
+    double ns;
+    while(fscanf(file, "%127s %lf", name, &ns) == 2)
+        baseline[name] = ns;
+    fclose(file);
+
+    double scale = 1;
+    const char* reference = "libc.localtime_r";
+    if(baseline.count(reference) && perfResults.count(reference) && baseline[reference] > 0)
+        scale = perfResults[reference] / baseline[reference];
+    printf("  baseline scaled by %.2f (%s)\n", scale, reference);
+
+    bool ok = true;
+    for(map<string, double>::iterator it = baseline.begin(); it != baseline.end(); ++it){
+        map<string, double>::iterator current = perfResults.find(it->first);
+        if(current == perfResults.end() || it->first.compare(0, 5, "libc.") == 0)
+            continue;
+
+        double expected = it->second * scale;
+        if(current->second > expected * (1 + margin / 100)){
+            printf("  REGRESSION %s: %.1f ns/op, baseline %.1f ns/op (+%.0f%%)\n",
+                it->first.c_str(), current->second, expected,
+                (current->second / expected - 1) * 100);
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+bool saveBaseline(const char* path){
+    FILE* file = fopen(path, "w");
+    if(!file) return false;
+
+    for(map<string, double>::iterator it = perfResults.begin(); it != perfResults.end(); ++it)
+        fprintf(file, "%s %.1f\n", it->first.c_str(), it->second);
+
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    size_t randomCount = 100000;
+    size_t timers = 10000000;
+    const char* baselinePath = NULL;
+    const char* savePath = NULL;
+    double margin = 20;
+    int repeat = 5;
+
+    for(int i = 1; i + 1 < argc; i += 2){
+        if(!strcmp(argv[i], "--random")) randomCount = (size_t) atol(argv[i + 1]);
+        else if(!strcmp(argv[i], "--timers")) timers = (size_t) atol(argv[i + 1]);
+        else if(!strcmp(argv[i], "--baseline")) baselinePath = argv[i + 1];
+        else if(!strcmp(argv[i], "--margin")) margin = atof(argv[i + 1]);
+        else if(!strcmp(argv[i], "--save-baseline")) savePath = argv[i + 1];
+        else if(!strcmp(argv[i], "--repeat")) repeat = atoi(argv[i + 1]);
+    }
+
+    // fusos POSIX funcionam sem tzdata; os nomes Olson cobrem regras históricas
+    const char* zones[] = {
+        "UTC0",
+        "EST5EDT,M3.2.0,M11.1.0",
+        "BRT3BRST,M10.3.0/0,M2.3.0/0",
+        "LHST-10:30LHDT-11,M10.1.0,M4.1.0/2",
+        "IST-5:30",
+        "America/Sao_Paulo",
+        "Europe/London"
+    };
+
+    Date date;
+    checkIsoParsing();
+    checkRangeSets();
+    checkTimerWheel(randomCount / 4 + 1);
+    for(size_t z = 0; z < sizeof zones / sizeof zones[0]; z++){
+        setZone(zones[z]);
+        printf("TZ=%s\n", zones[z]);
+        sweepDays(date);
+        sweepBoundaries(date);
+        sweepRandom(date, randomCount);
+        checkSplit(randomCount / 50 + 1);
+        checkColumn(randomCount / 4 + 1);
+        checkDateOnly(date, randomCount / 4 + 1);
+        checkTimeOfDay(date, randomCount / 4 + 1);
+        checkFormatter(randomCount / 20 + 1);
+    }
+
+    bool ok = true;
+    printf("differential:\n");
+    for(map<string, DiffStats>::iterator it = diffStats.begin(); it != diffStats.end(); ++it){
+        printf("  %-28s %10lu checks %8lu mismatches\n", it->first.c_str(),
+            (unsigned long) it->second.checks, (unsigned long) it->second.failures);
+        if(it->second.failures) ok = false;
+    }
+
+    printf("performance:\n");
+    setZone("EST5EDT,M3.2.0,M11.1.0");
+    for(int r = 0; r < (repeat > 0 ? repeat : 1); r++){
+        benchDate(randomCount > 0 ? randomCount : 1);
+        if(timers > 0 && !benchTimerWheel(timers)) ok = false;
+    }
+    printPerf();
+
+    if(baselinePath && !compareBaseline(baselinePath, margin)) ok = false;
+    if(savePath && !saveBaseline(savePath)) ok = false;
+
+    printf(ok ? "OK\n" : "FAILED\n");
+
+	return ok ? 0 : 1;
+}